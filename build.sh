@@ -7,7 +7,9 @@ readonly release_dir=$scriptdir/build/release
 echo "Building Debug"
 cmake -S $scriptdir -B $debug_dir -DCMAKE_BUILD_TYPE=Debug \
     && cmake --build $debug_dir \
-    && ./build/debug/bin/librdb_test
+    && ./build/debug/bin/librdb_test \
+    && ./build/debug/bin/librdb_engine_test \
+    && ./build/debug/bin/librdb_storage_test
 
 #echo -e "\nBuilding Release"
 #cmake -S $scriptdir -B $release_dir -DCMAKE_BUILD_TYPE=Release \
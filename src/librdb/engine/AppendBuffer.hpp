@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace rdb::engine {
+
+// A growable array whose copies share storage, for values that are only
+// ever appended. A copy keeps seeing the values as of the copy while the
+// original goes on appending: appends land past the end of every copy, in
+// spare capacity of the shared block, so they never move or overwrite what
+// a copy reads. Only when the block is full, or another copy has already
+// appended past this one's end, are the values copied to a block of their
+// own.
+//
+// Copying is safe while another copy appends, but appends to copies of one
+// array must not run concurrently.
+template <typename T>
+class AppendBuffer {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+   public:
+    AppendBuffer() = default;
+    AppendBuffer(const AppendBuffer&) = default;
+    AppendBuffer& operator=(const AppendBuffer&) = default;
+    // Leave `other` empty.
+    AppendBuffer(AppendBuffer&& other) noexcept
+        : block_(std::move(other.block_)),
+          size_(std::exchange(other.size_, 0)) {}
+    AppendBuffer& operator=(AppendBuffer&& other) noexcept {
+        block_ = std::move(other.block_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    const T* data() const { return block_ ? block_->values_.get() : nullptr; }
+    // Only for setting the values extend() left unset.
+    T* mutable_data() { return block_ ? block_->values_.get() : nullptr; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return block_->values_[i]; }
+    const T& back() const { return block_->values_[size_ - 1]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+    // Grows at least twofold, so that reserving room for each of many
+    // small appends stays amortized O(1).
+    void reserve(size_t capacity) {
+        if (!appendable() || (capacity > block_->capacity_)) {
+            reallocate(std::max(capacity, size_ * 2));
+        }
+    }
+
+    void push_back(const T& value) { append(&value, 1); }
+
+    // Appends `count` values left unset, for the caller to write through
+    // the pointer returned, from several threads if it likes, before any
+    // copy reads them.
+    T* extend(size_t count) {
+        if (!appendable() || (size_ + count > block_->capacity_)) {
+            reallocate(std::max(size_ + count, size_ * 2));
+        }
+        T* values = block_->values_.get() + size_;
+        size_ += count;
+        block_->used_ = size_;
+        return values;
+    }
+
+    void append(const T* values, size_t count) {
+        if (count > 0) {
+            std::memcpy(extend(count), values, count * sizeof(T));
+        }
+    }
+
+    // Overwrites value `i` in place, so every copy sees the new value.
+    // Values stored this way must only be read with load(), which may run
+    // concurrently.
+    void store(size_t i, T value) {
+        __atomic_store_n(&block_->values_[i], value, __ATOMIC_RELAXED);
+    }
+    T load(size_t i) const {
+        return __atomic_load_n(&block_->values_[i], __ATOMIC_RELAXED);
+    }
+
+   private:
+    struct Block {
+        std::unique_ptr<T[]> values_;
+        size_t capacity_ = 0;
+        // Values any copy has appended; the rest of the block is free.
+        size_t used_ = 0;
+    };
+
+    bool appendable() const { return block_ && (block_->used_ == size_); }
+
+    void reallocate(size_t capacity) {
+        auto block = std::make_shared<Block>();
+        block->values_.reset(new T[std::max<size_t>(capacity, 16)]);
+        block->capacity_ = std::max<size_t>(capacity, 16);
+        block->used_ = size_;
+        if (size_ > 0) {
+            std::memcpy(block->values_.get(), data(), size_ * sizeof(T));
+        }
+        block_ = std::move(block);
+    }
+
+    std::shared_ptr<Block> block_;
+    size_t size_ = 0;
+};
+
+}  // namespace rdb::engine
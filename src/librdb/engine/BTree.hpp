@@ -0,0 +1,401 @@
+#pragma once
+
+#include <librdb/engine/Column.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rdb::engine {
+
+// B+-tree over (key, row) entries, so equal keys need no special casing
+// and entries with one key come out in row order. Nodes are fixed arrays
+// held in two vectors and addressed by index; within a node, keys, rows
+// and children are separate arrays so a search reads only keys. Leaves
+// are linked left to right for range scans, and the leftmost leaf is
+// always leaves_[0].
+template <typename Key>
+class BTree {
+   public:
+    using key_type = Key;
+
+    // About four cache lines of keys per node.
+    static constexpr size_t capacity =
+        std::max<size_t>(8, 256 / sizeof(Key));
+
+    BTree() { clear(); }
+
+    void insert(const Key& key, uint32_t row) {
+        const auto split = insert(root_, height_, key, row);
+        if (!split) {
+            return;
+        }
+        const uint32_t root = new_inner();
+        Inner& inner = inners_[root];
+        inner.size_ = 1;
+        inner.keys_[0] = split->key_;
+        inner.rows_[0] = split->row_;
+        inner.children_[0] = root_;
+        inner.children_[1] = split->node_;
+        root_ = root;
+        ++height_;
+    }
+
+    // Replaces the contents with `entries`, which must be sorted, packing
+    // every node full.
+    void build(const std::vector<std::pair<Key, uint32_t>>& entries) {
+        clear();
+        if (entries.empty()) {
+            return;
+        }
+
+        // The nodes of the level being built and the first entry below
+        // each of them.
+        std::vector<uint32_t> nodes;
+        std::vector<std::pair<Key, uint32_t>> firsts;
+        leaves_.clear();
+        for (size_t begin = 0; begin < entries.size(); begin += capacity) {
+            const size_t end = std::min(entries.size(), begin + capacity);
+            const uint32_t node = new_leaf();
+            Leaf& leaf = leaves_[node];
+            for (size_t i = begin; i < end; ++i) {
+                leaf.keys_[i - begin] = entries[i].first;
+                leaf.rows_[i - begin] = entries[i].second;
+            }
+            leaf.size_ = static_cast<uint32_t>(end - begin);
+            if (node > 0) {
+                leaves_[node - 1].next_ = node;
+            }
+            nodes.push_back(node);
+            firsts.push_back(entries[begin]);
+        }
+
+        height_ = 0;
+        while (nodes.size() > 1) {
+            std::vector<uint32_t> parents;
+            std::vector<std::pair<Key, uint32_t>> parent_firsts;
+            for (size_t begin = 0; begin < nodes.size();
+                 begin += capacity + 1) {
+                const size_t end =
+                    std::min(nodes.size(), begin + capacity + 1);
+                const uint32_t node = new_inner();
+                Inner& inner = inners_[node];
+                inner.children_[0] = nodes[begin];
+                for (size_t i = begin + 1; i < end; ++i) {
+                    inner.keys_[i - begin - 1] = firsts[i].first;
+                    inner.rows_[i - begin - 1] = firsts[i].second;
+                    inner.children_[i - begin] = nodes[i];
+                }
+                inner.size_ = static_cast<uint32_t>(end - begin - 1);
+                parents.push_back(node);
+                parent_firsts.push_back(firsts[begin]);
+            }
+            nodes = std::move(parents);
+            firsts = std::move(parent_firsts);
+            ++height_;
+        }
+        root_ = nodes.front();
+    }
+
+    // Rows whose key equals `key`, ascending. `key` may be of any type
+    // ordered against Key, e.g. std::string_view for std::string.
+    template <typename Probe>
+    Selection equal(const Probe& key) const {
+        Selection rows;
+        scan(seek(key, 0), [&](const Key& entry, uint32_t row) {
+            if (key < entry) {
+                return false;
+            }
+            rows.push_back(row);
+            return true;
+        });
+        return rows;
+    }
+
+    // Rows whose key is below `key`, or not above it if `inclusive`, in
+    // key order.
+    template <typename Probe>
+    Selection less(const Probe& key, bool inclusive) const {
+        Selection rows;
+        scan({0, 0}, [&](const Key& entry, uint32_t row) {
+            if (inclusive ? (key < entry) : !(entry < key)) {
+                return false;
+            }
+            rows.push_back(row);
+            return true;
+        });
+        return rows;
+    }
+
+    // Rows whose key is above `key`, or not below it if `inclusive`, in
+    // key order.
+    template <typename Probe>
+    Selection greater(const Probe& key, bool inclusive) const {
+        Selection rows;
+        scan(seek(key, inclusive ? 0 : last_row),
+             [&](const Key& /*entry*/, uint32_t row) {
+                 rows.push_back(row);
+                 return true;
+             });
+        return rows;
+    }
+
+    size_t height() const { return height_; }
+
+    void clear() {
+        leaves_.clear();
+        inners_.clear();
+        root_ = new_leaf();
+        height_ = 0;
+    }
+
+   private:
+    static constexpr uint32_t no_node = UINT32_MAX;
+    // Sorts after every real row, which is below the row count.
+    static constexpr uint32_t last_row = UINT32_MAX;
+
+    struct Leaf {
+        uint32_t size_ = 0;
+        uint32_t next_ = no_node;
+        std::array<Key, capacity> keys_{};
+        std::array<uint32_t, capacity> rows_{};
+    };
+
+    // children_[i] holds the entries from separator i - 1 up to, but not
+    // including, separator i.
+    struct Inner {
+        uint32_t size_ = 0;
+        std::array<Key, capacity> keys_{};
+        std::array<uint32_t, capacity> rows_{};
+        std::array<uint32_t, capacity + 1> children_{};
+    };
+
+    struct Position {
+        uint32_t leaf_;
+        uint32_t index_;
+    };
+
+    struct Split {
+        Key key_;
+        uint32_t row_;
+        // The new right sibling; key_ and row_ are its first entry.
+        uint32_t node_;
+    };
+
+    template <typename Left, typename Right>
+    static bool entry_less(
+        const Left& left_key,
+        uint32_t left_row,
+        const Right& right_key,
+        uint32_t right_row) {
+        if (left_key < right_key) {
+            return true;
+        }
+        return !(right_key < left_key) && (left_row < right_row);
+    }
+
+    // Number of entries in `node` below (key, row).
+    template <typename Node, typename Probe>
+    static size_t lower_bound(
+        const Node& node,
+        const Probe& key,
+        uint32_t row) {
+        size_t begin = 0;
+        size_t end = node.size_;
+        while (begin < end) {
+            const size_t middle = (begin + end) / 2;
+            if (entry_less(node.keys_[middle], node.rows_[middle], key, row)) {
+                begin = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+        return begin;
+    }
+
+    // The child of `inner` that holds (key, row).
+    template <typename Probe>
+    static size_t child_index(
+        const Inner& inner,
+        const Probe& key,
+        uint32_t row) {
+        size_t begin = 0;
+        size_t end = inner.size_;
+        while (begin < end) {
+            const size_t middle = (begin + end) / 2;
+            if (entry_less(
+                    key, row, inner.keys_[middle], inner.rows_[middle])) {
+                end = middle;
+            } else {
+                begin = middle + 1;
+            }
+        }
+        return begin;
+    }
+
+    uint32_t new_leaf() {
+        leaves_.emplace_back();
+        return static_cast<uint32_t>(leaves_.size() - 1);
+    }
+
+    uint32_t new_inner() {
+        inners_.emplace_back();
+        return static_cast<uint32_t>(inners_.size() - 1);
+    }
+
+    // The first entry not below (key, row).
+    template <typename Probe>
+    Position seek(const Probe& key, uint32_t row) const {
+        uint32_t node = root_;
+        for (size_t level = height_; level > 0; --level) {
+            const Inner& inner = inners_[node];
+            node = inner.children_[child_index(inner, key, row)];
+        }
+        const size_t index = lower_bound(leaves_[node], key, row);
+        return {node, static_cast<uint32_t>(index)};
+    }
+
+    // Calls visit(key, row) on the entries from `position` on until it
+    // returns false.
+    template <typename Visit>
+    void scan(Position position, const Visit& visit) const {
+        for (uint32_t node = position.leaf_; node != no_node;
+             node = leaves_[node].next_) {
+            const Leaf& leaf = leaves_[node];
+            for (size_t i = position.index_; i < leaf.size_; ++i) {
+                if (!visit(leaf.keys_[i], leaf.rows_[i])) {
+                    return;
+                }
+            }
+            position.index_ = 0;
+        }
+    }
+
+    template <typename Node>
+    static void insert_at(
+        Node& node,
+        size_t index,
+        const Key& key,
+        uint32_t row) {
+        std::move_backward(
+            node.keys_.begin() + index,
+            node.keys_.begin() + node.size_,
+            node.keys_.begin() + node.size_ + 1);
+        std::copy_backward(
+            node.rows_.begin() + index,
+            node.rows_.begin() + node.size_,
+            node.rows_.begin() + node.size_ + 1);
+        node.keys_[index] = key;
+        node.rows_[index] = row;
+        ++node.size_;
+    }
+
+    // Moves entries [from, size_) of `node` to the front of `right`.
+    template <typename Node>
+    static void move_tail(Node& node, size_t from, Node& right) {
+        std::move(
+            node.keys_.begin() + from,
+            node.keys_.begin() + node.size_,
+            right.keys_.begin());
+        std::copy(
+            node.rows_.begin() + from,
+            node.rows_.begin() + node.size_,
+            right.rows_.begin());
+        right.size_ = static_cast<uint32_t>(node.size_ - from);
+        node.size_ = static_cast<uint32_t>(from);
+    }
+
+    // Inserts into the subtree `level` levels above the leaves and
+    // returns the new sibling if `node` had to split. Nodes are fetched
+    // again after every new_*(), which may move them.
+    std::optional<Split> insert(
+        uint32_t node,
+        size_t level,
+        const Key& key,
+        uint32_t row) {
+        if (level == 0) {
+            return insert_into_leaf(node, key, row);
+        }
+
+        const size_t child = child_index(inners_[node], key, row);
+        const auto split =
+            insert(inners_[node].children_[child], level - 1, key, row);
+        if (!split) {
+            return std::nullopt;
+        }
+        if (inners_[node].size_ < capacity) {
+            insert_child(inners_[node], child, *split);
+            return std::nullopt;
+        }
+
+        // The middle separator moves up; the ones on either side of it
+        // stay with their children.
+        const uint32_t right = new_inner();
+        Inner& left_inner = inners_[node];
+        Inner& right_inner = inners_[right];
+        const size_t middle = capacity / 2;
+        Split up{
+            std::move(left_inner.keys_[middle]),
+            left_inner.rows_[middle],
+            right};
+        std::copy(
+            left_inner.children_.begin() + middle + 1,
+            left_inner.children_.begin() + left_inner.size_ + 1,
+            right_inner.children_.begin());
+        move_tail(left_inner, middle + 1, right_inner);
+        left_inner.size_ = static_cast<uint32_t>(middle);
+        if (child <= middle) {
+            insert_child(left_inner, child, *split);
+        } else {
+            insert_child(right_inner, child - middle - 1, *split);
+        }
+        return up;
+    }
+
+    std::optional<Split> insert_into_leaf(
+        uint32_t node,
+        const Key& key,
+        uint32_t row) {
+        const size_t index = lower_bound(leaves_[node], key, row);
+        if (leaves_[node].size_ < capacity) {
+            insert_at(leaves_[node], index, key, row);
+            return std::nullopt;
+        }
+
+        const uint32_t right = new_leaf();
+        Leaf& left_leaf = leaves_[node];
+        Leaf& right_leaf = leaves_[right];
+        const size_t middle = capacity / 2;
+        move_tail(left_leaf, middle, right_leaf);
+        right_leaf.next_ = left_leaf.next_;
+        left_leaf.next_ = right;
+        if (index <= middle) {
+            insert_at(left_leaf, index, key, row);
+        } else {
+            insert_at(right_leaf, index - middle, key, row);
+        }
+        return Split{right_leaf.keys_[0], right_leaf.rows_[0], right};
+    }
+
+    // Adds the separator of `split` after child `child` of `inner`.
+    static void insert_child(Inner& inner, size_t child, const Split& split) {
+        std::copy_backward(
+            inner.children_.begin() + child + 1,
+            inner.children_.begin() + inner.size_ + 1,
+            inner.children_.begin() + inner.size_ + 2);
+        inner.children_[child + 1] = split.node_;
+        insert_at(inner, child, split.key_, split.row_);
+    }
+
+    std::vector<Leaf> leaves_;
+    std::vector<Inner> inners_;
+    uint32_t root_ = 0;
+    // Levels of inner nodes above the leaves.
+    size_t height_ = 0;
+};
+
+}  // namespace rdb::engine
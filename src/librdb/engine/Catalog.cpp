@@ -0,0 +1,72 @@
+#include <librdb/engine/Catalog.hpp>
+
+#include <librdb/engine/Table.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::engine {
+
+std::shared_ptr<const Table> Catalog::find_table(
+    std::string_view name) const {
+    std::lock_guard lock(mutex_);
+    const auto it = tables_.find(name);
+    return it == tables_.end() ? nullptr : it->second;
+}
+
+bool Catalog::add_table(std::shared_ptr<const Table> table) {
+    std::lock_guard lock(mutex_);
+    std::string name = table->name();
+    return tables_.emplace(std::move(name), std::move(table)).second;
+}
+
+void Catalog::publish(std::shared_ptr<const Table> table) {
+    // The old version is released outside the lock, in case this was its
+    // last reference.
+    std::shared_ptr<const Table> old = std::move(table);
+    std::lock_guard lock(mutex_);
+    tables_.find(old->name())->second.swap(old);
+}
+
+bool Catalog::drop_table(std::string_view name) {
+    std::shared_ptr<const Table> old;
+    std::lock_guard lock(mutex_);
+    const auto it = tables_.find(name);
+    if (it == tables_.end()) {
+        return false;
+    }
+    old = std::move(it->second);
+    tables_.erase(it);
+    return true;
+}
+
+bool Catalog::has_index(std::string_view name) const {
+    for (const auto& table : tables()) {
+        if (table->find_index(name) != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t Catalog::size() const {
+    std::lock_guard lock(mutex_);
+    return tables_.size();
+}
+
+std::vector<std::shared_ptr<const Table>> Catalog::tables() const {
+    std::lock_guard lock(mutex_);
+    std::vector<std::shared_ptr<const Table>> tables;
+    tables.reserve(tables_.size());
+    for (const auto& [name, table] : tables_) {
+        tables.push_back(table);
+    }
+    return tables;
+}
+
+}  // namespace rdb::engine
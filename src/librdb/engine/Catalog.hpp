@@ -0,0 +1,42 @@
+#pragma once
+
+#include <librdb/engine/Table.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::engine {
+
+// The current version of each table, by name. Readers take a table and
+// keep it as a snapshot for as long as they need; writers replace it with
+// publish(). Thread safe, though writers must take turns.
+class Catalog {
+   public:
+    std::shared_ptr<const Table> find_table(std::string_view name) const;
+
+    // false if a table with that name already exists.
+    bool add_table(std::shared_ptr<const Table> table);
+    // Replaces the table of the same name, e.g. with its next version.
+    void publish(std::shared_ptr<const Table> table);
+    // false if there is no such table.
+    bool drop_table(std::string_view name);
+
+    // Index names are unique across tables.
+    bool has_index(std::string_view name) const;
+
+    size_t size() const;
+    // Every table, by name.
+    std::vector<std::shared_ptr<const Table>> tables() const;
+
+   private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const Table>, std::less<>> tables_;
+};
+
+}  // namespace rdb::engine
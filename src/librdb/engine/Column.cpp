@@ -0,0 +1,175 @@
+#include <librdb/engine/Column.hpp>
+
+#include <librdb/parser/Statements.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rdb::engine {
+
+Column::Column(Type type) : type_(type) {
+    if (type_ == Type::Text) {
+        text_offsets_.push_back(0);
+    }
+}
+
+size_t Column::size() const {
+    switch (type_) {
+        case Type::Int:
+            return ints_.size();
+        case Type::Real:
+            return reals_.size();
+        case Type::Text:
+            return text_offsets_.size() - 1;
+    }
+    return 0;
+}
+
+void Column::reserve(size_t rows) {
+    switch (type_) {
+        case Type::Int:
+            ints_.reserve(rows);
+            return;
+        case Type::Real:
+            reals_.reserve(rows);
+            return;
+        case Type::Text:
+            text_offsets_.reserve(rows + 1);
+            return;
+    }
+}
+
+void Column::append(std::string_view value) {
+    heap_.append(value.data(), value.size());
+    text_offsets_.push_back(heap_.size());
+}
+
+void Column::append_default() {
+    switch (type_) {
+        case Type::Int:
+            append(int32_t(0));
+            return;
+        case Type::Real:
+            append(0.0F);
+            return;
+        case Type::Text:
+            append(std::string_view());
+            return;
+    }
+}
+
+parser::Value Column::value(size_t row) const {
+    switch (type_) {
+        case Type::Int:
+            return ints_[row];
+        case Type::Real:
+            return reals_[row];
+        case Type::Text:
+            return text(row);
+    }
+    return text(row);
+}
+
+void Column::append(const Column& source, const Selection& rows) {
+    reserve(size() + rows.size());
+    for (const uint32_t row : rows) {
+        switch (type_) {
+            case Type::Int:
+                append(source.ints_[row]);
+                break;
+            case Type::Real:
+                append(source.reals_[row]);
+                break;
+            case Type::Text:
+                append(source.text(row));
+                break;
+        }
+    }
+}
+
+void Column::append(const Column& source) {
+    switch (type_) {
+        case Type::Int:
+            ints_.append(source.ints_.data(), source.ints_.size());
+            return;
+        case Type::Real:
+            reals_.append(source.reals_.data(), source.reals_.size());
+            return;
+        case Type::Text: {
+            const size_t base = heap_.size();
+            heap_.append(source.heap_.data(), source.heap_.size());
+            text_offsets_.reserve(text_offsets_.size() + source.size());
+            for (size_t row = 1; row <= source.size(); ++row) {
+                text_offsets_.push_back(base + source.text_offsets_[row]);
+            }
+            return;
+        }
+    }
+}
+
+void Column::extend(size_t rows, size_t bytes) {
+    switch (type_) {
+        case Type::Int:
+            ints_.extend(rows);
+            return;
+        case Type::Real:
+            reals_.extend(rows);
+            return;
+        case Type::Text:
+            heap_.extend(bytes);
+            text_offsets_.extend(rows);
+            return;
+    }
+}
+
+void Column::fill(size_t row, size_t byte, const Column& source) {
+    const size_t rows = source.size();
+    switch (type_) {
+        case Type::Int:
+            std::copy_n(source.ints_.data(), rows, ints_.mutable_data() + row);
+            return;
+        case Type::Real:
+            std::copy_n(
+                source.reals_.data(), rows, reals_.mutable_data() + row);
+            return;
+        case Type::Text: {
+            const size_t first = source.text_offsets_[0];
+            std::copy_n(
+                source.heap_.data() + first,
+                source.text_offsets_[rows] - first,
+                heap_.mutable_data() + byte);
+            size_t* offsets = text_offsets_.mutable_data() + row + 1;
+            for (size_t i = 1; i <= rows; ++i) {
+                offsets[i - 1] = byte + source.text_offsets_[i] - first;
+            }
+            return;
+        }
+    }
+}
+
+Column Column::gather(const Selection& rows) const {
+    Column column(type_);
+    column.append(*this, rows);
+    return column;
+}
+
+void Column::erase(const Selection& rows) {
+    if (rows.empty()) {
+        return;
+    }
+    Selection kept;
+    kept.reserve(size() - rows.size());
+    auto next_erased = rows.begin();
+    for (size_t row = 0; row < size(); ++row) {
+        if ((next_erased != rows.end()) && (*next_erased == row)) {
+            ++next_erased;
+            continue;
+        }
+        kept.push_back(static_cast<uint32_t>(row));
+    }
+    *this = gather(kept);
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <librdb/engine/AppendBuffer.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace rdb::engine {
+
+// Row numbers within a table, in ascending order.
+using Selection = std::vector<uint32_t>;
+
+// Content of a TEXT literal; the parser keeps the quotes in the lexeme.
+inline std::string_view unquote(std::string_view text) {
+    return text.substr(1, text.size() - 2);
+}
+
+// One table column stored contiguously: INT and REAL as plain arrays, TEXT
+// as a single character heap with an offset per row. Only the storage for
+// type() is used.
+//
+// Copies share the storage and are snapshots: a copy keeps its rows while
+// the original goes on appending, which is how a reader holds on to a
+// table that a writer is extending.
+class Column {
+   public:
+    using Type = parser::ColumnDef::Type;
+
+    explicit Column(Type type);
+
+    Type type() const { return type_; }
+    size_t size() const;
+    void reserve(size_t rows);
+
+    void append(int32_t value) { ints_.push_back(value); }
+    void append(float value) { reals_.push_back(value); }
+    void append(std::string_view value);
+    // 0, 0.0 or "" for rows an INSERT leaves out.
+    void append_default();
+
+    const AppendBuffer<int32_t>& ints() const { return ints_; }
+    const AppendBuffer<float>& reals() const { return reals_; }
+    std::string_view text(size_t row) const {
+        return std::string_view(
+            heap_.data() + text_offsets_[row],
+            text_offsets_[row + 1] - text_offsets_[row]);
+    }
+
+    // Every TEXT value back to back; row `row` starts at text_offset(row),
+    // and text_offset(size()) is the size of the heap.
+    std::string_view heap() const {
+        return std::string_view(heap_.data(), heap_.size());
+    }
+    size_t text_offset(size_t row) const { return text_offsets_[row]; }
+    const AppendBuffer<size_t>& text_offsets() const { return text_offsets_; }
+
+    // TEXT values point into this column's heap.
+    parser::Value value(size_t row) const;
+
+    // Appends the rows `rows` of `source`, which has the same type.
+    void append(const Column& source, const Selection& rows);
+    // Appends every row of `source`, which has the same type.
+    void append(const Column& source);
+
+    // Appends `rows` rows holding, for TEXT, `bytes` characters in all,
+    // to be set by fill() before anything reads them.
+    void extend(size_t rows, size_t bytes);
+    // Sets rows [row, row + source.size()) of the ones extend() added to
+    // those of `source`, with their TEXT starting at heap offset `byte`.
+    // Fills of different rows may run concurrently.
+    void fill(size_t row, size_t byte, const Column& source);
+
+    // Copy of the rows in `rows`.
+    Column gather(const Selection& rows) const;
+    // Removes the rows in `rows` and closes the gaps. The rest are copied
+    // to new storage, so copies of this column keep theirs.
+    void erase(const Selection& rows);
+
+   private:
+    Type type_;
+    AppendBuffer<int32_t> ints_;
+    AppendBuffer<float> reals_;
+    AppendBuffer<char> heap_;
+    AppendBuffer<size_t> text_offsets_;
+};
+
+}  // namespace rdb::engine
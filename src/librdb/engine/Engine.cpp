@@ -0,0 +1,259 @@
+#include <librdb/engine/Engine.hpp>
+
+#include <librdb/engine/Catalog.hpp>
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Predicate.hpp>
+#include <librdb/engine/Scan.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace {
+
+StatementResult make_error(ExecutionError::Kind kind, std::string name) {
+    StatementResult result;
+    result.error_ = ExecutionError{kind, std::move(name)};
+    return result;
+}
+
+StatementResult make_error(ExecutionError error) {
+    StatementResult result;
+    result.error_ = std::move(error);
+    return result;
+}
+
+// Rows matching the optional WHERE of a SELECT or DELETE.
+std::optional<ExecutionError> find_rows(
+    const Table& table,
+    const std::optional<parser::Expression>& expression,
+    Selection& rows) {
+    if (!expression) {
+        rows = all_rows(table);
+        return std::nullopt;
+    }
+    Predicate predicate;
+    if (auto error = bind_predicate(table, *expression, predicate)) {
+        return error;
+    }
+    rows = select_rows(table, predicate);
+    return std::nullopt;
+}
+
+}  // namespace
+
+Engine::Engine(ScanOptions scan_options)
+    : scan_options_(scan_options), pool_(scan_options.threads_) {}
+
+std::vector<StatementResult> Engine::execute(const parser::Script& script) {
+    std::vector<StatementResult> results;
+    results.reserve(script.statements_.size());
+    for (const auto& statement : script.statements_) {
+        results.push_back(execute(statement));
+    }
+    return results;
+}
+
+StatementResult Engine::execute(const parser::Statement& statement) {
+    if (const auto* select = std::get_if<parser::SelectStatement>(&statement)) {
+        return execute_select(*select);
+    }
+    std::lock_guard lock(write_mutex_);
+    return std::visit(
+        parser::Overloaded{
+            [&](const parser::CreateTableStatement& create) {
+                return execute_create_table(create);
+            },
+            [&](const parser::SelectStatement& select) {
+                return execute_select(select);
+            },
+            [&](const parser::InsertStatement& insert) {
+                return execute_insert(insert);
+            },
+            [&](const parser::DeleteStatement& remove) {
+                return execute_delete(remove);
+            },
+            [&](const parser::DropTableStatement& drop) {
+                return execute_drop_table(drop);
+            },
+            [&](const parser::CreateIndexStatement& create) {
+                return execute_create_index(create);
+            },
+        },
+        statement);
+}
+
+StatementResult Engine::execute_create_table(
+    const parser::CreateTableStatement& statement) {
+    std::vector<ColumnSchema> schema;
+    for (const auto& column_def : statement.column_defs()) {
+        for (const auto& column : schema) {
+            if (column.name_ == column_def.column_name_) {
+                return make_error(
+                    ExecutionError::Kind::DuplicateColumn, column.name_);
+            }
+        }
+        schema.push_back(
+            {std::string(column_def.column_name_), column_def.type_});
+    }
+
+    auto table = std::make_shared<Table>(
+        std::string(statement.table_name()), std::move(schema));
+    if (!catalog_.add_table(table)) {
+        return make_error(ExecutionError::Kind::TableExists, table->name());
+    }
+    return {};
+}
+
+StatementResult Engine::execute_select(
+    const parser::SelectStatement& statement) {
+    const auto table = catalog_.find_table(statement.table_name());
+    if (table == nullptr) {
+        return make_error(
+            ExecutionError::Kind::NoSuchTable,
+            std::string(statement.table_name()));
+    }
+
+    std::vector<size_t> columns;
+    for (const auto name : statement.column_names()) {
+        const auto index = table->column_index(name);
+        if (!index) {
+            return make_error(
+                ExecutionError::Kind::NoSuchColumn, std::string(name));
+        }
+        columns.push_back(*index);
+    }
+
+    std::optional<Predicate> predicate;
+    if (const auto& expression = statement.expression()) {
+        if (auto error =
+                bind_predicate(*table, *expression, predicate.emplace())) {
+            return make_error(std::move(*error));
+        }
+    }
+
+    StatementResult result;
+    for (const size_t index : columns) {
+        result.result_set_.column_names_.push_back(
+            table->schema()[index].name_);
+    }
+    result.result_set_.columns_ = scan_table(
+        *table,
+        predicate ? &*predicate : nullptr,
+        columns,
+        pool_,
+        scan_options_);
+    return result;
+}
+
+StatementResult Engine::execute_insert(
+    const parser::InsertStatement& statement) {
+    const auto table = catalog_.find_table(statement.table_name());
+    if (table == nullptr) {
+        return make_error(
+            ExecutionError::Kind::NoSuchTable,
+            std::string(statement.table_name()));
+    }
+    const auto next = table->next_version();
+    if (auto error = next->insert(statement)) {
+        return make_error(std::move(*error));
+    }
+    catalog_.publish(next);
+    StatementResult result;
+    result.rows_affected_ = statement.row_count();
+    return result;
+}
+
+StatementResult Engine::execute_delete(
+    const parser::DeleteStatement& statement) {
+    const auto table = catalog_.find_table(statement.table_name());
+    if (table == nullptr) {
+        return make_error(
+            ExecutionError::Kind::NoSuchTable,
+            std::string(statement.table_name()));
+    }
+
+    Selection rows;
+    if (auto error = find_rows(*table, statement.expression(), rows)) {
+        return make_error(std::move(*error));
+    }
+    if (!rows.empty()) {
+        const auto next = table->next_version();
+        next->erase(rows);
+        catalog_.publish(next);
+    }
+    StatementResult result;
+    result.rows_affected_ = rows.size();
+    return result;
+}
+
+StatementResult Engine::execute_drop_table(
+    const parser::DropTableStatement& statement) {
+    if (!catalog_.drop_table(statement.table_name())) {
+        return make_error(
+            ExecutionError::Kind::NoSuchTable,
+            std::string(statement.table_name()));
+    }
+    return {};
+}
+
+StatementResult Engine::execute_create_index(
+    const parser::CreateIndexStatement& statement) {
+    std::string name(statement.index_name());
+    if (catalog_.has_index(name)) {
+        return make_error(ExecutionError::Kind::IndexExists, std::move(name));
+    }
+    const auto table = catalog_.find_table(statement.table_name());
+    if (table == nullptr) {
+        return make_error(
+            ExecutionError::Kind::NoSuchTable,
+            std::string(statement.table_name()));
+    }
+    const auto column = table->column_index(statement.column_name());
+    if (!column) {
+        return make_error(
+            ExecutionError::Kind::NoSuchColumn,
+            std::string(statement.column_name()));
+    }
+    const auto next = table->next_version();
+    next->create_index(std::move(name), *column, statement.method());
+    catalog_.publish(next);
+    return {};
+}
+
+size_t Engine::vacuum(double min_dead_fraction) {
+    size_t dropped = 0;
+    for (const auto& table : catalog_.tables()) {
+        if (!table->dead_fraction_at_least(min_dead_fraction)) {
+            continue;
+        }
+        // Copying the rows is the slow part and needs no lock: writers go
+        // on publishing versions, and the copy catches up with the last.
+        const auto next = table->next_version();
+        const Selection kept = next->vacuum();
+
+        std::lock_guard lock(write_mutex_);
+        const auto current = catalog_.find_table(table->name());
+        if (!current || !current->extends(*table)) {
+            // Dropped, or vacuumed by another caller.
+            continue;
+        }
+        next->catch_up(*table, kept, *current);
+        catalog_.publish(next);
+        dropped += table->row_count() - kept.size();
+    }
+    return dropped;
+}
+
+}  // namespace rdb::engine
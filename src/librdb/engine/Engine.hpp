@@ -0,0 +1,85 @@
+#pragma once
+
+#include <librdb/engine/Catalog.hpp>
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Scan.hpp>
+#include <librdb/engine/ThreadPool.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rdb::engine {
+
+// Rows returned by a SELECT, one Column per selected name.
+struct ResultSet {
+    std::vector<std::string> column_names_;
+    std::vector<Column> columns_;
+
+    size_t row_count() const {
+        return columns_.empty() ? 0 : columns_.front().size();
+    }
+};
+
+struct StatementResult {
+    std::optional<ExecutionError> error_;
+    // Rows inserted or deleted.
+    size_t rows_affected_ = 0;
+    // Filled by SELECT only.
+    ResultSet result_set_;
+};
+
+// Executes parsed statements against an in-memory Catalog. A statement
+// that fails changes nothing and does not stop the ones after it.
+//
+// execute() may be called from several threads. Statements that change
+// tables run one at a time, each publishing new versions of them. A SELECT
+// reads the version current when it starts and takes no lock beyond a
+// short one on the table's indexes, so it neither waits for writers nor
+// holds them up. Deleted rows stay in place until vacuum().
+//
+// A SELECT that no index answers scans its table with scan_table(), in
+// parallel on a pool of threads shared by every statement.
+class Engine {
+   public:
+    explicit Engine(ScanOptions scan_options = {});
+
+    std::vector<StatementResult> execute(const parser::Script& script);
+    StatementResult execute(const parser::Statement& statement);
+
+    // Drops the rows deleted from every table where they are at least
+    // `min_dead_fraction` of the rows stored. The rows kept are copied
+    // without blocking writers; the write lock is only taken to apply
+    // what writers changed meanwhile and publish the copy. SELECTs
+    // already running keep the versions they read. Returns the rows
+    // dropped.
+    size_t vacuum(double min_dead_fraction = 0);
+
+    // Changing tables directly must not overlap with execute() or
+    // vacuum() of statements that do.
+    Catalog& catalog() { return catalog_; }
+    const Catalog& catalog() const { return catalog_; }
+
+   private:
+    StatementResult execute_create_table(
+        const parser::CreateTableStatement& statement);
+    StatementResult execute_select(const parser::SelectStatement& statement);
+    StatementResult execute_insert(const parser::InsertStatement& statement);
+    StatementResult execute_delete(const parser::DeleteStatement& statement);
+    StatementResult execute_drop_table(
+        const parser::DropTableStatement& statement);
+    StatementResult execute_create_index(
+        const parser::CreateIndexStatement& statement);
+
+    std::mutex write_mutex_;
+    Catalog catalog_;
+    ScanOptions scan_options_;
+    ThreadPool pool_;
+};
+
+}  // namespace rdb::engine
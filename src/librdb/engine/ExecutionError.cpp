@@ -0,0 +1,35 @@
+#include <librdb/engine/ExecutionError.hpp>
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace rdb::engine {
+
+std::string ExecutionError::to_string() const {
+    std::stringstream out;
+    out << *this;
+    return out.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const ExecutionError& error) {
+    switch (error.kind_) {
+        case ExecutionError::Kind::TableExists:
+            return os << "Table '" << error.name_ << "' already exists";
+        case ExecutionError::Kind::NoSuchTable:
+            return os << "No table '" << error.name_ << "'";
+        case ExecutionError::Kind::NoSuchColumn:
+            return os << "No column '" << error.name_ << "'";
+        case ExecutionError::Kind::DuplicateColumn:
+            return os << "Duplicate column '" << error.name_ << "'";
+        case ExecutionError::Kind::TypeMismatch:
+            return os << "Type mismatch for '" << error.name_ << "'";
+        case ExecutionError::Kind::UnboundParameter:
+            return os << "Unbound parameter '" << error.name_ << "'";
+        case ExecutionError::Kind::IndexExists:
+            return os << "Index '" << error.name_ << "' already exists";
+    }
+    return os;
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace rdb::engine {
+
+// Why a statement could not be executed. Like parser::Diagnostic it is
+// formatted only by to_string() or operator<<.
+struct ExecutionError {
+    enum class Kind : uint8_t {
+        TableExists,
+        NoSuchTable,
+        NoSuchColumn,
+        DuplicateColumn,
+        // A value or comparison that does not fit the column type.
+        TypeMismatch,
+        // A `?` or `$N` placeholder left in a statement that was executed
+        // without PreparedStatement::bind().
+        UnboundParameter,
+        IndexExists,
+    };
+
+    Kind kind_;
+    // The table, column, parameter or index the error is about.
+    std::string name_;
+
+    std::string to_string() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const ExecutionError& error);
+
+}  // namespace rdb::engine
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <librdb/engine/Column.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace detail {
+
+inline uint64_t hash_key(int32_t key) {
+    return static_cast<uint32_t>(key);
+}
+
+inline uint64_t hash_key(float key) {
+    // -0.0 and 0.0 compare equal, so they must hash alike.
+    key += 0.0F;
+    uint32_t bits = 0;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t hash_key(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+}
+
+}  // namespace detail
+
+// Open-addressing hash table with linear probing from a key to the rows
+// holding it. Each distinct key takes one slot; rows with equal keys are
+// chained through next_ in the order they were inserted, which must be
+// ascending, so equal() returns a Selection without sorting.
+template <typename Key>
+class HashIndex {
+   public:
+    using key_type = Key;
+
+    void insert(const Key& key, uint32_t row) {
+        if ((size_ + 1) * 4 > slots_.size() * 3) {
+            grow();
+        }
+        next_.resize(row + 1, no_row);
+        Slot& slot = slots_[find_slot(key)];
+        if (slot.first_ == no_row) {
+            slot.key_ = key;
+            slot.first_ = row;
+            ++size_;
+        } else {
+            next_[slot.last_] = row;
+        }
+        slot.last_ = row;
+    }
+
+    // Rows holding `key`, which may be of any type comparable with Key,
+    // e.g. std::string_view for std::string.
+    template <typename Probe>
+    Selection equal(const Probe& key) const {
+        Selection rows;
+        if (slots_.empty()) {
+            return rows;
+        }
+        const Slot& slot = slots_[find_slot(key)];
+        for (uint32_t row = slot.first_; row != no_row; row = next_[row]) {
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    // Number of distinct keys.
+    size_t size() const { return size_; }
+
+    void clear() {
+        slots_.clear();
+        next_.clear();
+        size_ = 0;
+        shift_ = 64;
+    }
+
+   private:
+    static constexpr uint32_t no_row = UINT32_MAX;
+
+    struct Slot {
+        Key key_{};
+        // Empty while first_ is no_row.
+        uint32_t first_ = no_row;
+        uint32_t last_ = no_row;
+    };
+
+    // The slot holding `key`, or the empty slot where it belongs. The
+    // table is never full, so the probe ends.
+    template <typename Probe>
+    size_t find_slot(const Probe& key) const {
+        const size_t mask = slots_.size() - 1;
+        // Fibonacci hashing: the multiply spreads consecutive ids and the
+        // top bits pick the slot.
+        const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+        auto i = static_cast<size_t>(
+            (detail::hash_key(key) * multiplier) >> shift_);
+        while ((slots_[i].first_ != no_row) && !(slots_[i].key_ == key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        const size_t capacity = old.empty() ? 16 : old.size() * 2;
+        slots_.assign(capacity, Slot{});
+        shift_ = 64 - static_cast<unsigned>(__builtin_ctzll(capacity));
+        for (Slot& slot : old) {
+            if (slot.first_ != no_row) {
+                slots_[find_slot(slot.key_)] = std::move(slot);
+            }
+        }
+    }
+
+    // A power of two, at most 3/4 full.
+    std::vector<Slot> slots_;
+    // Next row with the same key, by row.
+    std::vector<uint32_t> next_;
+    size_t size_ = 0;
+    unsigned shift_ = 64;
+};
+
+}  // namespace rdb::engine
@@ -0,0 +1,167 @@
+#include <librdb/engine/Index.hpp>
+
+#include <librdb/engine/BTree.hpp>
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/HashIndex.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace {
+
+using Type = parser::ColumnDef::Type;
+using Operation = parser::Expression::Operation;
+
+template <typename Keys>
+constexpr bool is_btree =
+    std::is_same_v<Keys, BTree<typename Keys::key_type>>;
+
+template <typename Key>
+Key key_at(const Column& column, size_t row) {
+    if constexpr (std::is_same_v<Key, int32_t>) {
+        return column.ints()[row];
+    } else if constexpr (std::is_same_v<Key, float>) {
+        return column.reals()[row];
+    } else {
+        return Key(column.text(row));
+    }
+}
+
+// `key` as compared with a Key: TEXT is looked up without a copy.
+template <typename Key>
+auto probe(const parser::Value& key) {
+    if constexpr (std::is_same_v<Key, std::string>) {
+        return std::get<std::string_view>(key);
+    } else {
+        return std::get<Key>(key);
+    }
+}
+
+template <typename Keys>
+void insert_rows(Keys& keys, const Column& column, size_t first_row) {
+    using Key = typename Keys::key_type;
+    for (size_t row = first_row; row < column.size(); ++row) {
+        keys.insert(key_at<Key>(column, row), static_cast<uint32_t>(row));
+    }
+}
+
+Selection sorted(Selection rows) {
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+// Rows below `row_count` that are not in `rows`.
+Selection complement(const Selection& rows, size_t row_count) {
+    Selection others;
+    others.reserve(row_count - rows.size());
+    auto next = rows.begin();
+    for (size_t row = 0; row < row_count; ++row) {
+        if ((next != rows.end()) && (*next == row)) {
+            ++next;
+            continue;
+        }
+        others.push_back(static_cast<uint32_t>(row));
+    }
+    return others;
+}
+
+}  // namespace
+
+Index::Index(std::string name, size_t column, Method method, Column::Type type)
+    : name_(std::move(name)), column_(column), method_(method) {
+    const bool hash = method_ == Method::Hash;
+    switch (type) {
+        case Type::Int:
+            hash ? void(keys_.emplace<HashIndex<int32_t>>())
+                 : void(keys_.emplace<BTree<int32_t>>());
+            return;
+        case Type::Real:
+            hash ? void(keys_.emplace<HashIndex<float>>())
+                 : void(keys_.emplace<BTree<float>>());
+            return;
+        case Type::Text:
+            hash ? void(keys_.emplace<HashIndex<std::string>>())
+                 : void(keys_.emplace<BTree<std::string>>());
+            return;
+    }
+}
+
+bool Index::supports(Operation operation) const {
+    return (method_ == Method::BTree) || (operation == Operation::Eq) ||
+        (operation == Operation::Neq);
+}
+
+void Index::append(const Column& column, size_t first_row) {
+    std::visit(
+        [&](auto& keys) { insert_rows(keys, column, first_row); }, keys_);
+    row_count_ = column.size();
+}
+
+void Index::rebuild(const Column& column) {
+    std::visit(
+        [&](auto& keys) {
+            using Keys = std::decay_t<decltype(keys)>;
+            using Key = typename Keys::key_type;
+            if constexpr (is_btree<Keys>) {
+                // Bulk loading packs the leaves, unlike one insert per row.
+                std::vector<std::pair<Key, uint32_t>> entries;
+                entries.reserve(column.size());
+                for (size_t row = 0; row < column.size(); ++row) {
+                    entries.emplace_back(
+                        key_at<Key>(column, row), static_cast<uint32_t>(row));
+                }
+                std::stable_sort(
+                    entries.begin(),
+                    entries.end(),
+                    [](const auto& left, const auto& right) {
+                        return left.first < right.first;
+                    });
+                keys.build(entries);
+            } else {
+                keys.clear();
+                insert_rows(keys, column, 0);
+            }
+        },
+        keys_);
+    row_count_ = column.size();
+}
+
+Selection Index::lookup(Operation operation, const parser::Value& key) const {
+    return std::visit(
+        [&](const auto& keys) {
+            using Keys = std::decay_t<decltype(keys)>;
+            const auto value = probe<typename Keys::key_type>(key);
+            if (operation == Operation::Neq) {
+                return complement(keys.equal(value), row_count_);
+            }
+            if constexpr (is_btree<Keys>) {
+                switch (operation) {
+                    case Operation::Lt:
+                        return sorted(keys.less(value, false));
+                    case Operation::Lte:
+                        return sorted(keys.less(value, true));
+                    case Operation::Rt:
+                        return sorted(keys.greater(value, false));
+                    case Operation::Rte:
+                        return sorted(keys.greater(value, true));
+                    case Operation::Eq:
+                    case Operation::Neq:
+                        break;
+                }
+            }
+            return keys.equal(value);
+        },
+        keys_);
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <librdb/engine/BTree.hpp>
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/HashIndex.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+
+namespace rdb::engine {
+
+// A secondary index on one table column, kept in step by its Table. TEXT
+// keys are copied into the index.
+class Index {
+   public:
+    using Method = parser::CreateIndexStatement::Method;
+
+    Index(std::string name, size_t column, Method method, Column::Type type);
+
+    const std::string& name() const { return name_; }
+    size_t column() const { return column_; }
+    Method method() const { return method_; }
+
+    // Whether lookup() answers `operation`: `=` and `!=` always, the
+    // others only with a BTREE.
+    bool supports(parser::Expression::Operation operation) const;
+
+    // Indexes rows [first_row, column.size()) of the indexed column.
+    void append(const Column& column, size_t first_row);
+    // Indexes `column` from scratch, e.g. after rows were erased and the
+    // ones after them renumbered.
+    void rebuild(const Column& column);
+
+    // Rows whose key compares with `key` as `operation`, ascending. `key`
+    // has the column's type: int32_t, float or unquoted text.
+    Selection lookup(
+        parser::Expression::Operation operation,
+        const parser::Value& key) const;
+
+   private:
+    using Keys = std::variant<
+        HashIndex<int32_t>,
+        HashIndex<float>,
+        HashIndex<std::string>,
+        BTree<int32_t>,
+        BTree<float>,
+        BTree<std::string>>;
+
+    std::string name_;
+    size_t column_;
+    Method method_;
+    Keys keys_;
+    size_t row_count_ = 0;
+};
+
+}  // namespace rdb::engine
@@ -0,0 +1,299 @@
+#include <librdb/engine/Kernels.hpp>
+
+#include <librdb/parser/Statements.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RDB_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace rdb::engine {
+
+namespace {
+
+using Operation = parser::Expression::Operation;
+
+const size_t n_operations = 6;
+
+// Indexed by operation.
+template <typename Left, typename Right>
+using KernelArray = std::array<Kernel<Left, Right>, n_operations>;
+
+// A constant, read like a column.
+template <typename T>
+struct Repeat {
+    T operator[](size_t /*i*/) const { return value_; }
+
+    T value_;
+};
+
+template <Operation Op, typename Left, typename Right>
+bool compare(const Left& left, const Right& right) {
+    if constexpr (!std::is_same_v<Left, Right>) {
+        return compare<Op>(
+            static_cast<double>(left), static_cast<double>(right));
+    } else if constexpr (Op == Operation::Lt) {
+        return left < right;
+    } else if constexpr (Op == Operation::Rt) {
+        return left > right;
+    } else if constexpr (Op == Operation::Eq) {
+        return left == right;
+    } else if constexpr (Op == Operation::Lte) {
+        return left <= right;
+    } else if constexpr (Op == Operation::Rte) {
+        return left >= right;
+    } else {
+        return left != right;
+    }
+}
+
+// Values [first, count). Branch-free: every row is written, but only
+// matches advance `n`.
+template <Operation Op, typename Left, typename Right>
+size_t select_scalar(
+    Left left,
+    Right right,
+    size_t first,
+    size_t count,
+    uint32_t base,
+    uint32_t* out) {
+    size_t n = 0;
+    for (size_t i = first; i < count; ++i) {
+        out[n] = base + static_cast<uint32_t>(i);
+        n += compare<Op>(left[i], right[i]) ? 1 : 0;
+    }
+    return n;
+}
+
+#ifdef RDB_KERNELS_X86
+
+const size_t avx_lanes = 8;
+
+using CompressTable = std::array<std::array<uint32_t, avx_lanes>, 256>;
+
+// Row 'mask' lists the positions of the set bits of `mask`, so a single
+// store turns a comparison mask into selection vector entries.
+constexpr CompressTable make_compress_table() {
+    CompressTable table{};
+    for (uint32_t mask = 0; mask < table.size(); ++mask) {
+        size_t n = 0;
+        for (uint32_t lane = 0; lane < avx_lanes; ++lane) {
+            if ((mask & (1U << lane)) != 0) {
+                table[mask][n++] = lane;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr CompressTable compress_table = make_compress_table();
+
+// Values [i, i + 8).
+__attribute__((target("avx2"))) inline __m256i load_lanes(
+    const int32_t* values,
+    size_t i) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+}
+
+__attribute__((target("avx2"))) inline __m256i load_lanes(
+    Repeat<int32_t> values,
+    size_t /*i*/) {
+    return _mm256_set1_epi32(values.value_);
+}
+
+__attribute__((target("avx2"))) inline __m256 load_lanes(
+    const float* values,
+    size_t i) {
+    return _mm256_loadu_ps(values + i);
+}
+
+__attribute__((target("avx2"))) inline __m256 load_lanes(
+    Repeat<float> values,
+    size_t /*i*/) {
+    return _mm256_set1_ps(values.value_);
+}
+
+// One bit per lane where `l Op r` holds.
+template <Operation Op>
+__attribute__((target("avx2"))) inline uint32_t compare_lanes(
+    __m256i l,
+    __m256i r) {
+    __m256i matches;
+    if constexpr ((Op == Operation::Lt) || (Op == Operation::Rte)) {
+        matches = _mm256_cmpgt_epi32(r, l);
+    } else if constexpr ((Op == Operation::Rt) || (Op == Operation::Lte)) {
+        matches = _mm256_cmpgt_epi32(l, r);
+    } else {
+        matches = _mm256_cmpeq_epi32(l, r);
+    }
+    auto mask = static_cast<uint32_t>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+    // AVX2 has no <=, >= or != on integers: negate <, > and ==.
+    if constexpr (
+        (Op == Operation::Lte) || (Op == Operation::Rte) ||
+        (Op == Operation::Neq)) {
+        mask ^= 0xFF;
+    }
+    return mask;
+}
+
+template <Operation Op>
+__attribute__((target("avx2"))) inline uint32_t compare_lanes(
+    __m256 l,
+    __m256 r) {
+    constexpr int predicate = (Op == Operation::Lt) ? _CMP_LT_OQ
+        : (Op == Operation::Rt)                     ? _CMP_GT_OQ
+        : (Op == Operation::Eq)                     ? _CMP_EQ_OQ
+        : (Op == Operation::Lte)                    ? _CMP_LE_OQ
+        : (Op == Operation::Rte)                    ? _CMP_GE_OQ
+                                                    : _CMP_NEQ_UQ;
+    return static_cast<uint32_t>(
+        _mm256_movemask_ps(_mm256_cmp_ps(l, r, predicate)));
+}
+
+template <Operation Op, typename Left, typename Right>
+__attribute__((target("avx2"))) size_t select_avx2(
+    Left left,
+    Right right,
+    size_t count,
+    uint32_t base,
+    uint32_t* out) {
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + avx_lanes <= count; i += avx_lanes) {
+        const uint32_t mask =
+            compare_lanes<Op>(load_lanes(left, i), load_lanes(right, i));
+        // Always stores eight rows; n <= i keeps them inside `out`.
+        const __m256i lanes = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(compress_table[mask].data()));
+        const auto row = static_cast<int32_t>(base + i);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + n),
+            _mm256_add_epi32(lanes, _mm256_set1_epi32(row)));
+        n += static_cast<size_t>(__builtin_popcount(mask));
+    }
+    return n + select_scalar<Op>(left, right, i, count, base, out + n);
+}
+
+#endif  // RDB_KERNELS_X86
+
+// Whether there are AVX2 kernels for `Left` compared with `Right`: INT or
+// REAL with a column or constant of its own type.
+template <typename T, typename Left, typename Right>
+constexpr bool lanes_of = std::is_same_v<Left, const T*> &&
+    (std::is_same_v<Right, const T*> || std::is_same_v<Right, Repeat<T>>);
+
+template <typename Left, typename Right>
+constexpr bool vectorized =
+    lanes_of<int32_t, Left, Right> || lanes_of<float, Left, Right>;
+
+bool cpu_has_avx2() {
+#ifdef RDB_KERNELS_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+const bool has_avx2 = cpu_has_avx2();
+
+template <Operation Op, bool Avx2, typename Left, typename Right>
+size_t select_columns(
+    Left left,
+    Right right,
+    size_t count,
+    uint32_t base,
+    uint32_t* out) {
+#ifdef RDB_KERNELS_X86
+    if constexpr (Avx2) {
+        return select_avx2<Op>(left, right, count, base, out);
+    }
+#endif
+    return select_scalar<Op>(left, right, 0, count, base, out);
+}
+
+template <Operation Op, bool Avx2, typename Values, typename Constant>
+size_t select_constant(
+    Values values,
+    Constant constant,
+    size_t count,
+    uint32_t base,
+    uint32_t* out) {
+    return select_columns<Op, Avx2>(
+        values, Repeat<Constant>{constant}, count, base, out);
+}
+
+template <bool Avx2, typename Values, typename Constant, size_t... Ops>
+KernelArray<Values, Constant> constant_kernels(
+    std::index_sequence<Ops...> /*operations*/) {
+    return {select_constant<static_cast<Operation>(Ops), Avx2, Values,
+                            Constant>...};
+}
+
+template <bool Avx2, typename Left, typename Right, size_t... Ops>
+KernelArray<Left, Right> column_kernels(
+    std::index_sequence<Ops...> /*operations*/) {
+    return {select_columns<static_cast<Operation>(Ops), Avx2, Left,
+                           Right>...};
+}
+
+template <typename Values, typename Constant>
+KernelArray<Values, Constant> make_constant_kernels() {
+    const auto operations = std::make_index_sequence<n_operations>();
+    if constexpr (vectorized<Values, Repeat<Constant>>) {
+        if (has_avx2) {
+            return constant_kernels<true, Values, Constant>(operations);
+        }
+    }
+    return constant_kernels<false, Values, Constant>(operations);
+}
+
+template <typename Left, typename Right>
+KernelArray<Left, Right> make_column_kernels() {
+    const auto operations = std::make_index_sequence<n_operations>();
+    if constexpr (vectorized<Left, Right>) {
+        if (has_avx2) {
+            return column_kernels<true, Left, Right>(operations);
+        }
+    }
+    return column_kernels<false, Left, Right>(operations);
+}
+
+size_t index(Operation operation) {
+    return static_cast<size_t>(operation);
+}
+
+}  // namespace
+
+template <typename Values, typename Constant>
+Kernel<Values, Constant> constant_kernel(Operation operation) {
+    static const auto kernels = make_constant_kernels<Values, Constant>();
+    return kernels[index(operation)];
+}
+
+template <typename Left, typename Right>
+Kernel<Left, Right> column_kernel(Operation operation) {
+    static const auto kernels = make_column_kernels<Left, Right>();
+    return kernels[index(operation)];
+}
+
+template Kernel<const int32_t*, int32_t> constant_kernel(Operation);
+template Kernel<const float*, float> constant_kernel(Operation);
+template Kernel<const float*, double> constant_kernel(Operation);
+template Kernel<TextValues, std::string_view> constant_kernel(Operation);
+
+template Kernel<const int32_t*, const int32_t*> column_kernel(Operation);
+template Kernel<const int32_t*, const float*> column_kernel(Operation);
+template Kernel<const float*, const int32_t*> column_kernel(Operation);
+template Kernel<const float*, const float*> column_kernel(Operation);
+template Kernel<TextValues, TextValues> column_kernel(Operation);
+
+}  // namespace rdb::engine
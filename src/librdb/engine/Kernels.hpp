@@ -0,0 +1,57 @@
+#pragma once
+
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rdb::engine {
+
+// Scans run over batches of this many rows, so a selection buffer and the
+// column slices it indexes stay in L1.
+inline constexpr size_t batch_size = 1024;
+
+// The TEXT values of a column: value i spans [offsets_[i], offsets_[i + 1])
+// of heap_.
+struct TextValues {
+    std::string_view operator[](size_t i) const {
+        return std::string_view(
+            heap_ + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    const char* heap_;
+    const size_t* offsets_;
+};
+
+// A kernel compares `count` values of `left` with `right`, a constant or
+// a second column, writes `base + i` to `out` for every i where the
+// comparison holds and returns the number of rows written. `out` must
+// have room for `count` rows.
+//
+// There is one kernel per operation and operand types, each a template
+// instance with the comparison built in, so a scan does no per-row
+// dispatch. Values of two types are compared as double. INT and REAL
+// compared with their own type use AVX2 when the CPU supports it, which
+// is checked once at startup.
+template <typename Left, typename Right>
+using Kernel = size_t (*)(
+    Left left,
+    Right right,
+    size_t count,
+    uint32_t base,
+    uint32_t* out);
+
+// The kernel for `value operation constant`. Exists for Values and
+// Constant of const int32_t* and int32_t, const float* and float, const
+// float* and double, and TextValues and std::string_view.
+template <typename Values, typename Constant>
+Kernel<Values, Constant> constant_kernel(
+    parser::Expression::Operation operation);
+
+// The kernel for `left operation right` on two columns. Exists for every
+// pair of const int32_t* and const float*, and for two TextValues.
+template <typename Left, typename Right>
+Kernel<Left, Right> column_kernel(parser::Expression::Operation operation);
+
+}  // namespace rdb::engine
@@ -0,0 +1,543 @@
+#include <librdb/engine/Predicate.hpp>
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/engine/Kernels.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace rdb::engine {
+
+namespace {
+
+using Type = parser::ColumnDef::Type;
+using Operation = parser::Expression::Operation;
+
+std::optional<ExecutionError> bind_operand(
+    const Table& table,
+    const parser::Expression::Operand& operand,
+    Predicate::Operand& bound) {
+    if (const auto* name = std::get_if<std::string_view>(&operand)) {
+        const auto index = table.column_index(*name);
+        if (!index) {
+            return ExecutionError{
+                ExecutionError::Kind::NoSuchColumn, std::string(*name)};
+        }
+        bound.column_ = *index;
+        bound.type_ = table.schema()[*index].type_;
+        return std::nullopt;
+    }
+
+    const auto& value = std::get<parser::Value>(operand);
+    if (const auto* parameter = std::get_if<parser::Parameter>(&value)) {
+        return ExecutionError{
+            ExecutionError::Kind::UnboundParameter,
+            "$" + std::to_string(parameter->index_ + 1)};
+    }
+    if (const auto* text = std::get_if<std::string_view>(&value)) {
+        bound.literal_ = unquote(*text);
+        bound.type_ = Type::Text;
+    } else {
+        bound.literal_ = value;
+        bound.type_ = std::holds_alternative<int32_t>(value) ? Type::Int
+                                                             : Type::Real;
+    }
+    return std::nullopt;
+}
+
+std::string operand_name(const parser::Expression::Operand& operand) {
+    if (const auto* name = std::get_if<std::string_view>(&operand)) {
+        return std::string(*name);
+    }
+    const auto& value = std::get<parser::Value>(operand);
+    if (const auto* number = std::get_if<int32_t>(&value)) {
+        return std::to_string(*number);
+    }
+    if (const auto* number = std::get_if<float>(&value)) {
+        return std::to_string(*number);
+    }
+    return std::string(std::get<std::string_view>(value));
+}
+
+template <typename T>
+bool compare(Operation operation, const T& left, const T& right) {
+    switch (operation) {
+        case Operation::Lt:
+            return left < right;
+        case Operation::Rt:
+            return left > right;
+        case Operation::Eq:
+            return left == right;
+        case Operation::Lte:
+            return left <= right;
+        case Operation::Rte:
+            return left >= right;
+        case Operation::Neq:
+            return left != right;
+    }
+    return false;
+}
+
+parser::Value operand_value(
+    const Table& table,
+    const Predicate::Operand& operand,
+    size_t row) {
+    if (operand.column_) {
+        return table.column(*operand.column_).value(row);
+    }
+    return operand.literal_;
+}
+
+// int32_t and float both convert to double exactly.
+double as_double(const parser::Value& value) {
+    if (const auto* number = std::get_if<int32_t>(&value)) {
+        return *number;
+    }
+    return std::get<float>(value);
+}
+
+// Row-at-a-time reference semantics, used only when both sides are
+// literals.
+bool evaluate(const Table& table, const Predicate& predicate, size_t row) {
+    const parser::Value left = operand_value(table, predicate.left_, row);
+    const parser::Value right = operand_value(table, predicate.right_, row);
+    switch (predicate.comparison_) {
+        case Predicate::Comparison::Int:
+            return compare(
+                predicate.operation_,
+                std::get<int32_t>(left),
+                std::get<int32_t>(right));
+        case Predicate::Comparison::Real:
+            return compare(
+                predicate.operation_, as_double(left), as_double(right));
+        case Predicate::Comparison::Text:
+            return compare(
+                predicate.operation_,
+                std::get<std::string_view>(left),
+                std::get<std::string_view>(right));
+    }
+    return false;
+}
+
+// `a op b` as `b op' a`.
+Operation flip(Operation operation) {
+    switch (operation) {
+        case Operation::Lt:
+            return Operation::Rt;
+        case Operation::Rt:
+            return Operation::Lt;
+        case Operation::Lte:
+            return Operation::Rte;
+        case Operation::Rte:
+            return Operation::Lte;
+        case Operation::Eq:
+        case Operation::Neq:
+            break;
+    }
+    return operation;
+}
+
+// `x op c` for every int32_t x rewritten as `x operation_ constant_`, with
+// an integral constant_ that may lie outside the int32_t range.
+struct IntComparison {
+    Operation operation_;
+    int64_t constant_;
+};
+
+IntComparison int_comparison(Operation operation, double constant) {
+    // Anything this far out compares like an infinity; keeps the
+    // conversions below defined.
+    const double limit = 1e12;
+    constant = std::clamp(constant, -limit, limit);
+    const auto floor = static_cast<int64_t>(std::floor(constant));
+    const auto ceil = static_cast<int64_t>(std::ceil(constant));
+    switch (operation) {
+        case Operation::Lt:
+        case Operation::Rte:
+            return {operation, ceil};
+        case Operation::Rt:
+        case Operation::Lte:
+            return {operation, floor};
+        case Operation::Eq:
+        case Operation::Neq:
+            if (floor == ceil) {
+                return {operation, floor};
+            }
+            break;
+    }
+    // x == 2.5 never holds and x != 2.5 always does.
+    const auto never = std::numeric_limits<int64_t>::min();
+    return {operation == Operation::Eq ? Operation::Lt : Operation::Rt, never};
+}
+
+Selection row_range(size_t begin, size_t end) {
+    Selection rows(end - begin);
+    for (size_t row = begin; row < end; ++row) {
+        rows[row - begin] = static_cast<uint32_t>(row);
+    }
+    return rows;
+}
+
+// Runs `select_batch(first, count, out)` over every batch of rows [begin,
+// end) and collects what it selects.
+template <typename SelectBatch>
+Selection select_batches(
+    size_t begin,
+    size_t end,
+    const SelectBatch& select_batch) {
+    Selection rows;
+    size_t n = 0;
+    for (size_t first = begin; first < end; first += batch_size) {
+        const size_t count = std::min(batch_size, end - first);
+        rows.resize(n + count);
+        n += select_batch(first, count, rows.data() + n);
+    }
+    rows.resize(n);
+    return rows;
+}
+
+TextValues text_values(const Column& column) {
+    return TextValues{column.heap().data(), column.text_offsets().data()};
+}
+
+// `values` from row `row` on.
+template <typename T>
+const T* skip(const T* values, size_t row) {
+    return values + row;
+}
+
+TextValues skip(TextValues values, size_t row) {
+    return TextValues{values.heap_, values.offsets_ + row};
+}
+
+// Runs `kernel`, picked once for the whole scan, on rows [begin, end) of
+// `values` and `constant`.
+template <typename Values, typename Constant>
+Selection select_constant(
+    size_t begin,
+    size_t end,
+    Kernel<Values, Constant> kernel,
+    Values values,
+    Constant constant) {
+    return select_batches(
+        begin, end, [&](size_t first, size_t count, uint32_t* out) {
+            return kernel(
+                skip(values, first),
+                constant,
+                count,
+                static_cast<uint32_t>(first),
+                out);
+        });
+}
+
+// The same for a kernel comparing columns `left` and `right`.
+template <typename Left, typename Right>
+Selection select_columns(
+    size_t begin,
+    size_t end,
+    Kernel<Left, Right> kernel,
+    Left left,
+    Right right) {
+    return select_batches(
+        begin, end, [&](size_t first, size_t count, uint32_t* out) {
+            return kernel(
+                skip(left, first),
+                skip(right, first),
+                count,
+                static_cast<uint32_t>(first),
+                out);
+        });
+}
+
+Selection select_int32_constant(
+    size_t begin,
+    size_t end,
+    Operation operation,
+    const int32_t* values,
+    int64_t constant) {
+    const int64_t min = std::numeric_limits<int32_t>::min();
+    const int64_t max = std::numeric_limits<int32_t>::max();
+    if ((constant < min) || (constant > max)) {
+        // Every int32_t compares the same way with such a constant.
+        const int64_t any = constant < min ? min : max;
+        return compare(operation, any, constant) ? row_range(begin, end)
+                                                 : Selection();
+    }
+    return select_constant(
+        begin,
+        end,
+        constant_kernel<const int32_t*, int32_t>(operation),
+        values,
+        static_cast<int32_t>(constant));
+}
+
+Selection select_with_constant(
+    const Table& table,
+    const Predicate& predicate,
+    size_t begin,
+    size_t end) {
+    const Operation operation = predicate.operation_;
+    const Column& column = table.column(*predicate.left_.column_);
+    const parser::Value& constant = predicate.right_.literal_;
+
+    if (predicate.comparison_ == Predicate::Comparison::Text) {
+        return select_constant(
+            begin,
+            end,
+            constant_kernel<TextValues, std::string_view>(operation),
+            text_values(column),
+            std::get<std::string_view>(constant));
+    }
+
+    if (column.type() == Type::Int) {
+        const IntComparison comparison =
+            predicate.comparison_ == Predicate::Comparison::Int
+            ? IntComparison{operation, std::get<int32_t>(constant)}
+            : int_comparison(operation, as_double(constant));
+        return select_int32_constant(
+            begin,
+            end,
+            comparison.operation_,
+            column.ints().data(),
+            comparison.constant_);
+    }
+
+    // A REAL column: compare as float when that is exact, which it is for
+    // every REAL literal and for INT literals up to 2^24.
+    const double value = as_double(constant);
+    const auto value_float = static_cast<float>(value);
+    if (static_cast<double>(value_float) != value) {
+        return select_constant(
+            begin,
+            end,
+            constant_kernel<const float*, double>(operation),
+            column.reals().data(),
+            value);
+    }
+    return select_constant(
+        begin,
+        end,
+        constant_kernel<const float*, float>(operation),
+        column.reals().data(),
+        value_float);
+}
+
+// A column compared with a constant, as a lookup of a key of the column's
+// type that selects the same rows.
+struct IndexLookup {
+    Operation operation_;
+    parser::Value key_;
+};
+
+std::optional<IndexLookup> index_lookup(
+    const Table& table,
+    const Predicate& predicate) {
+    const Operation operation = predicate.operation_;
+    const Column& column = table.column(*predicate.left_.column_);
+    const parser::Value& constant = predicate.right_.literal_;
+    switch (column.type()) {
+        case Type::Int: {
+            const IntComparison comparison =
+                predicate.comparison_ == Predicate::Comparison::Int
+                ? IntComparison{operation, std::get<int32_t>(constant)}
+                : int_comparison(operation, as_double(constant));
+            if ((comparison.constant_ < std::numeric_limits<int32_t>::min()) ||
+                (comparison.constant_ > std::numeric_limits<int32_t>::max())) {
+                return std::nullopt;
+            }
+            return IndexLookup{
+                comparison.operation_,
+                static_cast<int32_t>(comparison.constant_)};
+        }
+        case Type::Real: {
+            const double value = as_double(constant);
+            const auto value_float = static_cast<float>(value);
+            if (static_cast<double>(value_float) != value) {
+                return std::nullopt;
+            }
+            return IndexLookup{operation, value_float};
+        }
+        case Type::Text:
+            break;
+    }
+    return IndexLookup{operation, constant};
+}
+
+const Index* find_index(
+    const Table& table,
+    size_t column,
+    Operation operation) {
+    const Index* found = nullptr;
+    for (const auto& index : table.indexes()) {
+        if ((index.column() != column) || !index.supports(operation)) {
+            continue;
+        }
+        if (index.method() == Index::Method::Hash) {
+            return &index;
+        }
+        found = &index;
+    }
+    return found;
+}
+
+std::optional<Selection> select_with_index(
+    const Table& table,
+    const Predicate& predicate) {
+    const auto lookup = index_lookup(table, predicate);
+    if (!lookup) {
+        return std::nullopt;
+    }
+    Selection rows;
+    {
+        const auto lock = table.lock_indexes();
+        const Index* index =
+            find_index(table, *predicate.left_.column_, lookup->operation_);
+        if (index == nullptr) {
+            return std::nullopt;
+        }
+        rows = index->lookup(lookup->operation_, lookup->key_);
+    }
+    // Rows a later version appended.
+    rows.erase(
+        std::lower_bound(rows.begin(), rows.end(), table.row_count()),
+        rows.end());
+    return rows;
+}
+
+Selection select_with_column(
+    const Table& table,
+    const Predicate& predicate,
+    size_t begin,
+    size_t end) {
+    const Operation operation = predicate.operation_;
+    const Column& left = table.column(*predicate.left_.column_);
+    const Column& right = table.column(*predicate.right_.column_);
+
+    if (predicate.comparison_ == Predicate::Comparison::Text) {
+        return select_columns(
+            begin,
+            end,
+            column_kernel<TextValues, TextValues>(operation),
+            text_values(left),
+            text_values(right));
+    }
+    const auto select = [&](auto left_values, auto right_values) {
+        using Left = decltype(left_values);
+        using Right = decltype(right_values);
+        return select_columns(
+            begin,
+            end,
+            column_kernel<Left, Right>(operation),
+            left_values,
+            right_values);
+    };
+    if (left.type() == Type::Int) {
+        return right.type() == Type::Int
+            ? select(left.ints().data(), right.ints().data())
+            : select(left.ints().data(), right.reals().data());
+    }
+    return right.type() == Type::Int
+        ? select(left.reals().data(), right.ints().data())
+        : select(left.reals().data(), right.reals().data());
+}
+
+}  // namespace
+
+std::optional<ExecutionError> bind_predicate(
+    const Table& table,
+    const parser::Expression& expression,
+    Predicate& predicate) {
+    if (auto error = bind_operand(table, expression.left_, predicate.left_)) {
+        return error;
+    }
+    if (auto error =
+            bind_operand(table, expression.right_, predicate.right_)) {
+        return error;
+    }
+    predicate.operation_ = expression.operation_;
+
+    const Type left = predicate.left_.type_;
+    const Type right = predicate.right_.type_;
+    if ((left == Type::Text) != (right == Type::Text)) {
+        const bool left_is_column = predicate.left_.column_.has_value();
+        return ExecutionError{
+            ExecutionError::Kind::TypeMismatch,
+            operand_name(
+                left_is_column ? expression.left_ : expression.right_)};
+    }
+    // Kernels take the column on the left.
+    if (!predicate.left_.column_ && predicate.right_.column_) {
+        std::swap(predicate.left_, predicate.right_);
+        predicate.operation_ = flip(predicate.operation_);
+    }
+
+    if (left == Type::Text) {
+        predicate.comparison_ = Predicate::Comparison::Text;
+    } else if ((left == Type::Int) && (right == Type::Int)) {
+        predicate.comparison_ = Predicate::Comparison::Int;
+    } else {
+        predicate.comparison_ = Predicate::Comparison::Real;
+    }
+    return std::nullopt;
+}
+
+Selection select_rows(const Table& table, const Predicate& predicate) {
+    if (predicate.left_.column_ && !predicate.right_.column_) {
+        if (auto rows = select_with_index(table, predicate)) {
+            table.remove_deleted(*rows);
+            return std::move(*rows);
+        }
+    }
+    return select_range(table, predicate, 0, table.row_count());
+}
+
+Selection select_range(
+    const Table& table,
+    const Predicate& predicate,
+    size_t begin,
+    size_t end) {
+    if (!predicate.left_.column_) {
+        return evaluate(table, predicate, 0) ? all_rows(table, begin, end)
+                                             : Selection();
+    }
+    Selection rows = predicate.right_.column_
+        ? select_with_column(table, predicate, begin, end)
+        : select_with_constant(table, predicate, begin, end);
+    table.remove_deleted(rows);
+    return rows;
+}
+
+const Index* choose_index(const Table& table, const Predicate& predicate) {
+    if (!predicate.left_.column_ || predicate.right_.column_) {
+        return nullptr;
+    }
+    const auto lookup = index_lookup(table, predicate);
+    if (!lookup) {
+        return nullptr;
+    }
+    return find_index(table, *predicate.left_.column_, lookup->operation_);
+}
+
+Selection all_rows(const Table& table) {
+    return all_rows(table, 0, table.row_count());
+}
+
+Selection all_rows(const Table& table, size_t begin, size_t end) {
+    Selection rows = row_range(begin, end);
+    table.remove_deleted(rows);
+    return rows;
+}
+
+}  // namespace rdb::engine
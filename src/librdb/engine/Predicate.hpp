@@ -0,0 +1,68 @@
+#pragma once
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <optional>
+
+namespace rdb::engine {
+
+// A WHERE expression with its column names resolved against one table and
+// its TEXT literals unquoted.
+struct Predicate {
+    // How both sides are compared: as int32_t, as floating point or as text.
+    enum class Comparison {
+        Int,
+        Real,
+        Text,
+    };
+
+    struct Operand {
+        // The column read for each row, or std::nullopt for literal_.
+        std::optional<size_t> column_;
+        parser::Value literal_;
+        parser::ColumnDef::Type type_;
+    };
+
+    Operand left_;
+    parser::Expression::Operation operation_;
+    Operand right_;
+    Comparison comparison_;
+};
+
+// Fails on unknown columns and on comparing TEXT with a number. A column
+// compared with a literal always ends up in left_.
+std::optional<ExecutionError> bind_predicate(
+    const Table& table,
+    const parser::Expression& expression,
+    Predicate& predicate);
+
+// Rows of `table` for which `predicate` holds, leaving out the ones
+// deleted as of its version. A column compared with a constant is looked
+// up in choose_index() if it returns an index. Otherwise the column is
+// scanned batch by batch with the kernel in Kernels.hpp for the operation
+// and operand types, picked once per scan.
+Selection select_rows(const Table& table, const Predicate& predicate);
+// Like select_rows() restricted to rows [begin, end), always by a scan.
+Selection select_range(
+    const Table& table,
+    const Predicate& predicate,
+    size_t begin,
+    size_t end);
+
+// An index on the column `predicate` compares with a constant that
+// supports the comparison, HASH before BTREE, or nullptr. Constants that
+// no key of the column's type stands for exactly, such as 2.5 for an INT
+// column, are left to the scan. Only valid under table.lock_indexes().
+const Index* choose_index(const Table& table, const Predicate& predicate);
+
+// Every row of `table` not deleted as of its version.
+Selection all_rows(const Table& table);
+// The same among rows [begin, end).
+Selection all_rows(const Table& table, size_t begin, size_t end);
+
+}  // namespace rdb::engine
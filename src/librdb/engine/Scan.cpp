@@ -0,0 +1,124 @@
+#include <librdb/engine/Scan.hpp>
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/Predicate.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/engine/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace {
+
+std::vector<Column> empty_columns(
+    const Table& table,
+    const std::vector<size_t>& columns) {
+    std::vector<Column> result;
+    result.reserve(columns.size());
+    for (const size_t column : columns) {
+        result.emplace_back(table.schema()[column].type_);
+    }
+    return result;
+}
+
+void project(
+    const Table& table,
+    const std::vector<size_t>& columns,
+    const Selection& rows,
+    std::vector<Column>& out) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        out[i].append(table.column(columns[i]), rows);
+    }
+}
+
+// Joins `parts` in order. Each part is copied to its place in the result
+// by a morsel of its own, so that the copying, which for a wide result
+// costs as much as the scan, runs in parallel too.
+std::vector<Column> concatenate(
+    const Table& table,
+    const std::vector<size_t>& columns,
+    std::vector<std::vector<Column>>& parts,
+    ThreadPool& pool) {
+    // Where each part starts in the result: rows[part] and, per column,
+    // bytes[part][i] of TEXT.
+    std::vector<size_t> rows(parts.size() + 1, 0);
+    std::vector<std::vector<size_t>> bytes(
+        parts.size() + 1, std::vector<size_t>(columns.size(), 0));
+    for (size_t part = 0; part < parts.size(); ++part) {
+        rows[part + 1] =
+            rows[part] + (columns.empty() ? 0 : parts[part][0].size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            bytes[part + 1][i] =
+                bytes[part][i] + parts[part][i].heap().size();
+        }
+    }
+    std::vector<Column> result = empty_columns(table, columns);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        result[i].extend(rows.back(), bytes.back()[i]);
+    }
+    pool.run(parts.size(), [&](size_t part, size_t /*slot*/) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            result[i].fill(rows[part], bytes[part][i], parts[part][i]);
+        }
+    });
+    return result;
+}
+
+}  // namespace
+
+std::vector<Column> scan_table(
+    const Table& table,
+    const Predicate* predicate,
+    const std::vector<size_t>& columns,
+    ThreadPool& pool,
+    const ScanOptions& options) {
+    const size_t row_count = table.row_count();
+    const size_t morsel_rows = std::max<size_t>(options.morsel_rows_, 1);
+    const size_t morsel_count = (row_count + morsel_rows - 1) / morsel_rows;
+    const bool indexed = (predicate != nullptr) && [&] {
+        const auto lock = table.lock_indexes();
+        return choose_index(table, *predicate) != nullptr;
+    }();
+
+    if (indexed || (morsel_count < 2) || (pool.thread_count() == 1)) {
+        const Selection rows = predicate != nullptr
+            ? select_rows(table, *predicate)
+            : all_rows(table);
+        std::vector<Column> result = empty_columns(table, columns);
+        project(table, columns, rows, result);
+        return result;
+    }
+
+    const auto select_morsel = [&](size_t morsel) {
+        const size_t begin = morsel * morsel_rows;
+        const size_t end = std::min(begin + morsel_rows, row_count);
+        return predicate != nullptr
+            ? select_range(table, *predicate, begin, end)
+            : all_rows(table, begin, end);
+    };
+    std::vector<std::vector<Column>> parts;
+    if (options.ordered_) {
+        // One part per morsel, joined in morsel order.
+        parts.resize(morsel_count);
+        pool.run(morsel_count, [&](size_t morsel, size_t /*slot*/) {
+            parts[morsel] = empty_columns(table, columns);
+            project(table, columns, select_morsel(morsel), parts[morsel]);
+        });
+    } else {
+        // One part per thread. Built one by one: copies would share
+        // storage, which two threads must not append to.
+        for (size_t slot = 0; slot < pool.thread_count(); ++slot) {
+            parts.push_back(empty_columns(table, columns));
+        }
+        pool.run(morsel_count, [&](size_t morsel, size_t slot) {
+            project(table, columns, select_morsel(morsel), parts[slot]);
+        });
+    }
+    return concatenate(table, columns, parts, pool);
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/Predicate.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/engine/ThreadPool.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace rdb::engine {
+
+struct ScanOptions {
+    // Threads a SELECT scans with, the calling one included: one per core
+    // if 0.
+    size_t threads_ = 0;
+    // Rows per morsel: enough to make claiming one cheap, few enough that
+    // a table spreads over every thread.
+    size_t morsel_rows_ = size_t(1) << 16;
+    // Whether rows come back in table order. Otherwise each thread
+    // collects the rows of its morsels straight into its own columns, and
+    // those are joined in no particular order.
+    bool ordered_ = true;
+};
+
+// The columns `columns` of the rows of `table` that `predicate` selects,
+// or of every row if it is nullptr: SELECT after binding. Predicates that
+// an index answers are looked up. Otherwise tables of more than one
+// morsel are filtered and projected a morsel at a time by the threads of
+// `pool`, and the results merged.
+std::vector<Column> scan_table(
+    const Table& table,
+    const Predicate* predicate,
+    const std::vector<size_t>& columns,
+    ThreadPool& pool,
+    const ScanOptions& options);
+
+}  // namespace rdb::engine
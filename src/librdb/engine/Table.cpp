@@ -0,0 +1,290 @@
+#include <librdb/engine/Table.hpp>
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace {
+
+using Type = parser::ColumnDef::Type;
+
+bool is_assignable(Type column_type, Type value_type) {
+    if (column_type == Type::Real) {
+        return value_type != Type::Text;
+    }
+    return column_type == value_type;
+}
+
+void append_values(
+    Column& column,
+    const parser::ValueColumn& values,
+    size_t row_count) {
+    column.reserve(column.size() + row_count);
+    for (size_t row = 0; row < row_count; ++row) {
+        switch (values.type_) {
+            case Type::Int:
+                if (column.type() == Type::Real) {
+                    column.append(static_cast<float>(values.ints_[row]));
+                } else {
+                    column.append(values.ints_[row]);
+                }
+                break;
+            case Type::Real:
+                column.append(values.reals_[row]);
+                break;
+            case Type::Text:
+                column.append(unquote(values.texts_[row]));
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+Table::Table(std::string name, std::vector<ColumnSchema> schema)
+    : name_(std::move(name)),
+      schema_(std::move(schema)),
+      indexes_(std::make_shared<Indexes>()) {
+    columns_.reserve(schema_.size());
+    for (const auto& column : schema_) {
+        columns_.emplace_back(column.type_);
+    }
+}
+
+std::shared_ptr<Table> Table::next_version() const {
+    auto next = std::make_shared<Table>(*this);
+    ++next->version_;
+    return next;
+}
+
+std::optional<size_t> Table::column_index(std::string_view name) const {
+    for (size_t i = 0; i < schema_.size(); ++i) {
+        if (schema_[i].name_ == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+void Table::remove_deleted(Selection& rows) const {
+    if (dead_rows_ == 0) {
+        return;
+    }
+    rows.erase(
+        std::remove_if(
+            rows.begin(),
+            rows.end(),
+            [&](uint32_t row) { return is_deleted(row); }),
+        rows.end());
+}
+
+std::optional<ExecutionError> Table::insert(
+    const parser::InsertStatement& insert) {
+    const auto names = insert.column_names();
+    std::vector<size_t> targets;
+    std::vector<bool> is_target(columns_.size(), false);
+    for (size_t i = 0; i < names.size(); ++i) {
+        const auto index = column_index(names[i]);
+        if (!index) {
+            return ExecutionError{
+                ExecutionError::Kind::NoSuchColumn, std::string(names[i])};
+        }
+        if (is_target[*index]) {
+            return ExecutionError{
+                ExecutionError::Kind::DuplicateColumn, std::string(names[i])};
+        }
+        const parser::ValueColumn& values = insert.columns()[i];
+        for (const parser::Value& value : values.values_) {
+            if (const auto* parameter =
+                    std::get_if<parser::Parameter>(&value)) {
+                return ExecutionError{
+                    ExecutionError::Kind::UnboundParameter,
+                    "$" + std::to_string(parameter->index_ + 1)};
+            }
+        }
+        if (!is_assignable(schema_[*index].type_, values.type_)) {
+            return ExecutionError{
+                ExecutionError::Kind::TypeMismatch, std::string(names[i])};
+        }
+        is_target[*index] = true;
+        targets.push_back(*index);
+    }
+
+    const size_t row_count = insert.row_count();
+    for (size_t i = 0; i < targets.size(); ++i) {
+        append_values(columns_[targets[i]], insert.columns()[i], row_count);
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (is_target[i]) {
+            continue;
+        }
+        for (size_t row = 0; row < row_count; ++row) {
+            columns_[i].append_default();
+        }
+    }
+    deleted_.reserve(row_count_ + row_count);
+    for (size_t row = 0; row < row_count; ++row) {
+        deleted_.push_back(live);
+    }
+    {
+        std::unique_lock lock(indexes_->mutex_);
+        for (auto& index : indexes_->indexes_) {
+            index.append(columns_[index.column()], row_count_);
+        }
+    }
+    row_count_ += row_count;
+    return std::nullopt;
+}
+
+void Table::erase(const Selection& rows) {
+    for (const uint32_t row : rows) {
+        deleted_.store(row, version_);
+    }
+    deletions_.append(rows.data(), rows.size());
+    dead_rows_ += rows.size();
+}
+
+Selection Table::vacuum() {
+    Selection kept;
+    kept.reserve(row_count_ - dead_rows_);
+    size_t first_dead = row_count_;
+    for (size_t row = 0; row < row_count_; ++row) {
+        if (!is_deleted(row)) {
+            kept.push_back(static_cast<uint32_t>(row));
+        } else if (first_dead == row_count_) {
+            first_dead = row;
+        }
+    }
+    std::vector<Column> columns;
+    columns.reserve(columns_.size());
+    for (const auto& column : columns_) {
+        columns.push_back(column.gather(kept));
+    }
+
+    const size_t unchanged_rows = std::min(unchanged_rows_, first_dead);
+    restore(std::move(columns));
+    unchanged_rows_ = unchanged_rows;
+    return kept;
+}
+
+void Table::catch_up(
+    const Table& earlier,
+    const Selection& kept,
+    const Table& later) {
+    for (size_t i = earlier.deletions_.size(); i < later.deletions_.size();
+         ++i) {
+        const uint32_t row = later.deletions_[i];
+        if (row >= earlier.row_count_) {
+            // Appended since; copied with its stamp below.
+            continue;
+        }
+        const auto renumbered = static_cast<uint32_t>(
+            std::lower_bound(kept.begin(), kept.end(), row) - kept.begin());
+        deleted_.store(renumbered, later.deleted_.load(row));
+        deletions_.push_back(renumbered);
+        ++dead_rows_;
+    }
+
+    const size_t first_row = row_count_;
+    Selection appended;
+    appended.reserve(later.row_count_ - earlier.row_count_);
+    for (size_t row = earlier.row_count_; row < later.row_count_; ++row) {
+        appended.push_back(static_cast<uint32_t>(row));
+        const uint64_t stamp = later.deleted_.load(row);
+        deleted_.push_back(stamp);
+        if (stamp != live) {
+            deletions_.push_back(static_cast<uint32_t>(row_count_));
+            ++dead_rows_;
+        }
+        ++row_count_;
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        columns_[i].append(later.columns_[i], appended);
+    }
+
+    // Not published yet, so the indexes are this version's alone.
+    for (auto& index : indexes_->indexes_) {
+        index.append(columns_[index.column()], first_row);
+    }
+    for (const auto& index : later.indexes()) {
+        if (find_index(index.name()) == nullptr) {
+            create_index(index.name(), index.column(), index.method());
+        }
+    }
+    version_ = later.version_ + 1;
+}
+
+void Table::restore(std::vector<Column> columns) {
+    columns_ = std::move(columns);
+    row_count_ = columns_.empty() ? 0 : columns_.front().size();
+    unchanged_rows_ = row_count_;
+    deleted_ = AppendBuffer<uint64_t>();
+    deleted_.reserve(row_count_);
+    for (size_t row = 0; row < row_count_; ++row) {
+        deleted_.push_back(live);
+    }
+    deletions_ = AppendBuffer<uint32_t>();
+    dead_rows_ = 0;
+    rebuild_indexes();
+}
+
+std::shared_lock<std::shared_mutex> Table::lock_indexes() const {
+    return std::shared_lock(indexes_->mutex_);
+}
+
+const Index* Table::find_index(std::string_view name) const {
+    for (const auto& index : indexes_->indexes_) {
+        if (index.name() == name) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+void Table::create_index(
+    std::string name,
+    size_t column,
+    Index::Method method) {
+    Index index(std::move(name), column, method, schema_[column].type_);
+    index.rebuild(columns_[column]);
+    std::unique_lock lock(indexes_->mutex_);
+    indexes_->indexes_.push_back(std::move(index));
+}
+
+void Table::rebuild_indexes() {
+    auto indexes = std::make_shared<Indexes>();
+    {
+        // Versions that still share the old indexes may be extending them.
+        const auto lock = lock_indexes();
+        indexes->indexes_.reserve(indexes_->indexes_.size());
+        for (const auto& old : indexes_->indexes_) {
+            indexes->indexes_.emplace_back(
+                old.name(),
+                old.column(),
+                old.method(),
+                schema_[old.column()].type_);
+        }
+    }
+    for (auto& index : indexes->indexes_) {
+        index.rebuild(columns_[index.column()]);
+    }
+    indexes_ = std::move(indexes);
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <librdb/engine/AppendBuffer.hpp>
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/ExecutionError.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/parser/Span.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdb::engine {
+
+struct ColumnSchema {
+    std::string name_;
+    parser::ColumnDef::Type type_;
+};
+
+// One version of a table. A published version is never changed, so it
+// serves as a snapshot: a writer takes next_version(), changes that and
+// publishes it in the Catalog, while readers of the old version go on
+// undisturbed. Versions share their storage, so a new one costs a copy of
+// the schema, and the old one is freed with its last reader.
+//
+// DELETE only stamps rows with the version that deleted them; the rows
+// stay, hidden from that version on, until vacuum() drops them. Vacuuming
+// copies the table, so it runs on a version writers have moved past, and
+// catch_up() then applies what they did since.
+class Table {
+   public:
+    Table(std::string name, std::vector<ColumnSchema> schema);
+
+    // A copy to change and publish as the version after this one.
+    std::shared_ptr<Table> next_version() const;
+
+    const std::string& name() const { return name_; }
+    const std::vector<ColumnSchema>& schema() const { return schema_; }
+    std::optional<size_t> column_index(std::string_view name) const;
+
+    uint64_t version() const { return version_; }
+
+    const Column& column(size_t index) const { return columns_[index]; }
+    // Rows stored, counting the deleted ones not yet vacuumed.
+    size_t row_count() const { return row_count_; }
+    // Rows deleted as of this version but not yet vacuumed.
+    size_t dead_rows() const { return dead_rows_; }
+    // Whether there are dead rows, at least `fraction` of those stored.
+    bool dead_fraction_at_least(double fraction) const {
+        return (dead_rows_ > 0) &&
+            (static_cast<double>(dead_rows_) >=
+             fraction * static_cast<double>(row_count_));
+    }
+    bool is_deleted(size_t row) const {
+        return deleted_.load(row) <= version_;
+    }
+    // Drops from `rows` the ones deleted as of this version.
+    void remove_deleted(Selection& rows) const;
+
+    // Appends every row of `insert`, or none of them if a column is
+    // unknown, named twice or holds values of another type. Columns the
+    // statement leaves out get 0, 0.0 or "".
+    std::optional<ExecutionError> insert(
+        const parser::InsertStatement& insert);
+
+    // Marks `rows`, which must not be deleted yet, deleted as of this
+    // version. Earlier versions still see them.
+    void erase(const Selection& rows);
+    // Drops the deleted rows, renumbering the others, and gives this
+    // version indexes of its own over the new numbering. Returns the rows
+    // kept, by their old numbers.
+    Selection vacuum();
+    // Whether this version holds the rows of `earlier`, numbered alike,
+    // with maybe more appended or deleted since: no vacuum() or restore()
+    // came between them.
+    bool extends(const Table& earlier) const {
+        return indexes_ == earlier.indexes_;
+    }
+    // For a version vacuum() made from `earlier`, keeping `kept`: applies
+    // what `later`, which extends() `earlier`, changed since, i.e. the rows
+    // it deleted, those it appended and the indexes it created, and numbers
+    // this version after it. Takes time in what changed, not in the rows
+    // stored.
+    void catch_up(
+        const Table& earlier,
+        const Selection& kept,
+        const Table& later);
+
+    // Replaces the rows with `columns`, e.g. as loaded from disk: one per
+    // schema entry, all of one size. Indexes are rebuilt, and every row
+    // counts as unchanged.
+    void restore(std::vector<Column> columns);
+    // Rows [0, unchanged_rows()) are as they were at the last
+    // mark_unchanged(); the ones after them were inserted or renumbered
+    // since. Lets a checkpoint write only what changed.
+    size_t unchanged_rows() const { return unchanged_rows_; }
+    void mark_unchanged() { unchanged_rows_ = row_count_; }
+
+    // The versions with one row numbering share their indexes, and a
+    // writer extends them in place, so they are read under this lock.
+    // Entries may name rows past row_count().
+    std::shared_lock<std::shared_mutex> lock_indexes() const;
+    const std::vector<Index>& indexes() const { return indexes_->indexes_; }
+    // For writers, which need no lock.
+    const Index* find_index(std::string_view name) const;
+    // Indexes every row of column `column`; the name is not checked.
+    void create_index(std::string name, size_t column, Index::Method method);
+
+   private:
+    struct Indexes {
+        std::shared_mutex mutex_;
+        std::vector<Index> indexes_;
+    };
+
+    // By row: the version that deleted it, or live.
+    static constexpr uint64_t live = UINT64_MAX;
+
+    // Indexes `columns_` afresh, away from earlier versions.
+    void rebuild_indexes();
+
+    std::string name_;
+    std::vector<ColumnSchema> schema_;
+    std::vector<Column> columns_;
+    AppendBuffer<uint64_t> deleted_;
+    // Rows in the order erase() deleted them, for catch_up().
+    AppendBuffer<uint32_t> deletions_;
+    size_t row_count_ = 0;
+    size_t dead_rows_ = 0;
+    uint64_t version_ = 0;
+    size_t unchanged_rows_ = 0;
+    std::shared_ptr<Indexes> indexes_;
+};
+
+}  // namespace rdb::engine
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <librdb/engine/Engine.hpp>
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Parser.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Helpers shared by the tests of the engine and of the libraries built on
+// it.
+namespace rdb::engine::test {
+
+inline std::string value_to_str(const parser::Value& value) {
+    if (const auto* number = std::get_if<int32_t>(&value)) {
+        return std::to_string(*number);
+    }
+    if (const auto* number = std::get_if<float>(&value)) {
+        return std::to_string(*number);
+    }
+    return std::string(std::get<std::string_view>(value));
+}
+
+// One line per statement: the error, the rows a SELECT returned, or the
+// number of rows changed.
+inline std::string results_to_str(const std::vector<StatementResult>& results) {
+    std::stringstream out;
+    for (const auto& result : results) {
+        if (result.error_) {
+            out << *result.error_ << '\n';
+            continue;
+        }
+        const auto& result_set = result.result_set_;
+        if (result_set.columns_.empty()) {
+            out << result.rows_affected_ << '\n';
+            continue;
+        }
+        for (size_t row = 0; row < result_set.row_count(); ++row) {
+            for (size_t column = 0; column < result_set.columns_.size();
+                 ++column) {
+                out << (column == 0 ? "" : " ")
+                    << value_to_str(result_set.columns_[column].value(row));
+            }
+            out << ';';
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+// Runs `input` on `executor`, an Engine or anything else that executes a
+// parser::Script, and prints the results.
+template <typename Executor>
+std::string execute(Executor& executor, std::string_view input) {
+    parser::Lexer lexer(input);
+    parser::Parser parser(lexer);
+    const auto parsed = parser.parse_sql_script();
+    EXPECT_TRUE(parsed.errors_.empty());
+    return results_to_str(executor.execute(parsed.script));
+}
+
+}  // namespace rdb::engine::test
@@ -0,0 +1,741 @@
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/Engine.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/engine/Kernels.hpp>
+#include <librdb/engine/Predicate.hpp>
+#include <librdb/engine/Scan.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/engine/TestUtil.hpp>
+#include <librdb/engine/ThreadPool.hpp>
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/PreparedStatement.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using rdb::engine::test::execute;
+
+TEST(EngineSuite, ColumnTest) {
+    rdb::engine::Column column(rdb::parser::ColumnDef::Type::Text);
+    for (const std::string_view text : {"a", "", "bc", "def", "g"}) {
+        column.append(text);
+    }
+    column.erase({1, 3});
+
+    ASSERT_EQ(3U, column.size());
+    EXPECT_EQ("a", column.text(0));
+    EXPECT_EQ("bc", column.text(1));
+    EXPECT_EQ("g", column.text(2));
+
+    const auto gathered = column.gather({2, 0});
+    ASSERT_EQ(2U, gathered.size());
+    EXPECT_EQ("g", gathered.text(0));
+    EXPECT_EQ("a", gathered.text(1));
+}
+
+TEST(EngineSuite, KernelsTest) {
+    using Operation = rdb::parser::Expression::Operation;
+    const Operation operations[] = {
+        Operation::Lt,
+        Operation::Rt,
+        Operation::Eq,
+        Operation::Lte,
+        Operation::Rte,
+        Operation::Neq,
+    };
+    const auto compare = [](Operation operation, auto left, auto right) {
+        switch (operation) {
+            case Operation::Lt:
+                return left < right;
+            case Operation::Rt:
+                return left > right;
+            case Operation::Eq:
+                return left == right;
+            case Operation::Lte:
+                return left <= right;
+            case Operation::Rte:
+                return left >= right;
+            case Operation::Neq:
+                return left != right;
+        }
+        return false;
+    };
+
+    // Odd sizes leave a scalar tail after the vector loop.
+    const size_t count = 1019;
+    const uint32_t base = 5000;
+    std::vector<int32_t> ints(count);
+    std::vector<int32_t> other_ints(count);
+    std::vector<float> reals(count);
+    std::vector<float> other_reals(count);
+    std::string heap;
+    std::vector<size_t> offsets = {0};
+    std::string other_heap;
+    std::vector<size_t> other_offsets = {0};
+    for (size_t i = 0; i < count; ++i) {
+        ints[i] = static_cast<int32_t>((i * 7919) % 13) - 6;
+        other_ints[i] = static_cast<int32_t>((i * 104729) % 11) - 5;
+        reals[i] = static_cast<float>(ints[i]) / 2;
+        other_reals[i] = static_cast<float>(other_ints[i]) / 2;
+        heap += std::to_string(ints[i]);
+        offsets.push_back(heap.size());
+        other_heap += std::to_string(other_ints[i]);
+        other_offsets.push_back(other_heap.size());
+    }
+    const rdb::engine::TextValues texts{heap.data(), offsets.data()};
+    const rdb::engine::TextValues other_texts{
+        other_heap.data(), other_offsets.data()};
+
+    using rdb::engine::column_kernel;
+    using rdb::engine::constant_kernel;
+    for (const Operation operation : operations) {
+        rdb::engine::Selection expected_constant;
+        rdb::engine::Selection expected_columns;
+        rdb::engine::Selection expected_mixed;
+        rdb::engine::Selection expected_mixed_reversed;
+        rdb::engine::Selection expected_text_constant;
+        rdb::engine::Selection expected_text_columns;
+        for (size_t i = 0; i < count; ++i) {
+            const auto row = base + static_cast<uint32_t>(i);
+            if (compare(operation, ints[i], 2)) {
+                expected_constant.push_back(row);
+            }
+            if (compare(operation, ints[i], other_ints[i])) {
+                expected_columns.push_back(row);
+            }
+            if (compare(operation, ints[i], double(other_reals[i]))) {
+                expected_mixed.push_back(row);
+            }
+            if (compare(operation, double(reals[i]), other_ints[i])) {
+                expected_mixed_reversed.push_back(row);
+            }
+            if (compare(operation, texts[i], std::string_view("-2"))) {
+                expected_text_constant.push_back(row);
+            }
+            if (compare(operation, texts[i], other_texts[i])) {
+                expected_text_columns.push_back(row);
+            }
+        }
+
+        rdb::engine::Selection out(count);
+        const auto check = [&](const rdb::engine::Selection& expected,
+                               auto kernel,
+                               auto left,
+                               auto right) {
+            out.resize(count);
+            out.resize(kernel(left, right, count, base, out.data()));
+            EXPECT_EQ(expected, out);
+        };
+        check(
+            expected_constant,
+            constant_kernel<const int32_t*, int32_t>(operation),
+            ints.data(),
+            2);
+        check(
+            expected_constant,
+            constant_kernel<const float*, float>(operation),
+            reals.data(),
+            1.0F);
+        check(
+            expected_constant,
+            constant_kernel<const float*, double>(operation),
+            reals.data(),
+            1.0);
+        check(
+            expected_columns,
+            column_kernel<const int32_t*, const int32_t*>(operation),
+            ints.data(),
+            other_ints.data());
+        check(
+            expected_columns,
+            column_kernel<const float*, const float*>(operation),
+            reals.data(),
+            other_reals.data());
+        check(
+            expected_mixed,
+            column_kernel<const int32_t*, const float*>(operation),
+            ints.data(),
+            other_reals.data());
+        check(
+            expected_mixed_reversed,
+            column_kernel<const float*, const int32_t*>(operation),
+            reals.data(),
+            other_ints.data());
+        check(
+            expected_text_constant,
+            constant_kernel<rdb::engine::TextValues, std::string_view>(
+                operation),
+            texts,
+            std::string_view("-2"));
+        check(
+            expected_text_columns,
+            column_kernel<rdb::engine::TextValues, rdb::engine::TextValues>(
+                operation),
+            texts,
+            other_texts);
+    }
+}
+
+TEST(EngineSuite, IndexTest) {
+    using Operation = rdb::parser::Expression::Operation;
+    using Method = rdb::engine::Index::Method;
+    using Type = rdb::parser::ColumnDef::Type;
+    const Operation operations[] = {
+        Operation::Lt,
+        Operation::Rt,
+        Operation::Eq,
+        Operation::Lte,
+        Operation::Rte,
+        Operation::Neq,
+    };
+    const auto compare = [](Operation operation, auto left, auto right) {
+        switch (operation) {
+            case Operation::Lt:
+                return left < right;
+            case Operation::Rt:
+                return left > right;
+            case Operation::Eq:
+                return left == right;
+            case Operation::Lte:
+                return left <= right;
+            case Operation::Rte:
+                return left >= right;
+            case Operation::Neq:
+                return left != right;
+        }
+        return false;
+    };
+
+    // Enough rows, with duplicates, for a few B+-tree levels.
+    const size_t count = 6000;
+    for (Method method : {Method::Hash, Method::BTree}) {
+        rdb::engine::Column ints(Type::Int);
+        rdb::engine::Column texts(Type::Text);
+        rdb::engine::Index int_index("i", 0, method, Type::Int);
+        rdb::engine::Index text_index("t", 0, method, Type::Text);
+        // Indexed chunk by chunk as rows arrive, then bulk loaded.
+        for (size_t row = 0; row < count; ++row) {
+            const auto value = static_cast<int32_t>((row * 7919) % 997) - 500;
+            ints.append(value);
+            texts.append("k" + std::to_string(value));
+            if ((row % 1000 == 999) || (row + 1 == count)) {
+                int_index.append(ints, row - row % 1000);
+                text_index.append(texts, row - row % 1000);
+            }
+        }
+        rdb::engine::Index int_bulk("i", 0, method, Type::Int);
+        int_bulk.rebuild(ints);
+        rdb::engine::Index text_bulk("t", 0, method, Type::Text);
+        text_bulk.rebuild(texts);
+
+        for (const Operation operation : operations) {
+            if (!int_index.supports(operation)) {
+                EXPECT_EQ(Method::Hash, method);
+                continue;
+            }
+            for (const int32_t key : {-501, -500, 0, 17, 496, 497}) {
+                const std::string text = "k" + std::to_string(key);
+                rdb::engine::Selection expected_ints;
+                rdb::engine::Selection expected_texts;
+                for (size_t row = 0; row < count; ++row) {
+                    if (compare(operation, ints.ints()[row], key)) {
+                        expected_ints.push_back(static_cast<uint32_t>(row));
+                    }
+                    if (compare(operation, texts.text(row), text)) {
+                        expected_texts.push_back(static_cast<uint32_t>(row));
+                    }
+                }
+                EXPECT_EQ(expected_ints, int_index.lookup(operation, key));
+                EXPECT_EQ(expected_ints, int_bulk.lookup(operation, key));
+                const auto text_key = std::string_view(text);
+                EXPECT_EQ(
+                    expected_texts, text_index.lookup(operation, text_key));
+                EXPECT_EQ(
+                    expected_texts, text_bulk.lookup(operation, text_key));
+            }
+        }
+    }
+}
+
+TEST(EngineSuite, WhereTest) {
+    rdb::engine::Engine engine;
+    std::string insert = "INSERT INTO t (a, b, c) VALUES (0, 0.5, \"s0\")";
+    for (int i = 1; i < 2100; ++i) {
+        const std::string n = std::to_string(i);
+        insert += ", (" + n + ", " + n + ".5, \"s" + n + "\")";
+    }
+    execute(engine, "CREATE TABLE t (a INT, b REAL, c TEXT);\n" + insert + ";");
+
+    EXPECT_EQ(
+        "0;1;2;\n"
+        "2097;2098;2099;\n"
+        "1500;\n"
+        "\n"
+        "2048;\n"
+        "1;\n"
+        "0;1;2;\n"
+        "\n"
+        "\n"
+        "0\n"
+        "2100\n",
+        execute(
+            engine,
+            "SELECT a FROM t WHERE a < 2.5;\n"
+            "SELECT a FROM t WHERE 2096.5 < a;\n"
+            "SELECT a FROM t WHERE a = 1500.0;\n"
+            "SELECT a FROM t WHERE a = 1500.5;\n"
+            "SELECT a FROM t WHERE b = 2048.5;\n"
+            "SELECT a FROM t WHERE c = \"s1\";\n"
+            "SELECT a FROM t WHERE 2 >= a;\n"
+            "SELECT a FROM t WHERE b < a;\n"
+            "SELECT a FROM t WHERE b > 16777217;\n"
+            "DELETE FROM t WHERE a >= b;\n"
+            "DELETE FROM t WHERE a > -3000000000.0;\n"));
+}
+
+TEST(EngineSuite, IndexedWhereTest) {
+    std::string insert = "INSERT INTO t (a, b, c) VALUES (0, 0.5, \"s0\")";
+    for (int i = 1; i < 2100; ++i) {
+        const std::string n = std::to_string(i % 700);
+        insert += ", (" + n + ", " + n + ".5, \"s" + n + "\")";
+    }
+    const std::string queries =
+        "SELECT a FROM t WHERE a < 2.5;\n"
+        "SELECT a FROM t WHERE 696.5 < a;\n"
+        "SELECT a FROM t WHERE a = 500.0;\n"
+        "SELECT a FROM t WHERE a = 500.5;\n"
+        "SELECT a FROM t WHERE a != 3;\n"
+        "SELECT a FROM t WHERE b = 648.5;\n"
+        "SELECT a FROM t WHERE b >= 698;\n"
+        "SELECT a FROM t WHERE c = \"s1\";\n"
+        "SELECT a FROM t WHERE c > \"s698\";\n"
+        "SELECT a FROM t WHERE b > 16777217;\n"
+        "DELETE FROM t WHERE a < 10;\n"
+        "SELECT a FROM t WHERE a <= 10;\n"
+        "INSERT INTO t (a, c) VALUES (5, \"s1\");\n"
+        "SELECT a FROM t WHERE c = \"s1\";\n"
+        "SELECT a FROM t WHERE a = 5;\n";
+
+    rdb::engine::Engine scanned;
+    execute(
+        scanned, "CREATE TABLE t (a INT, b REAL, c TEXT);\n" + insert + ";");
+    rdb::engine::Engine indexed;
+    EXPECT_EQ(
+        "0\n2100\n0\n0\n0\n0\n",
+        execute(
+            indexed,
+            "CREATE TABLE t (a INT, b REAL, c TEXT);\n" + insert +
+                ";\n"
+                "CREATE INDEX ta ON t (a);\n"
+                "CREATE INDEX tah ON t (a) USING HASH;\n"
+                "CREATE INDEX tb ON t (b) USING HASH;\n"
+                "CREATE INDEX tc ON t (c) USING BTREE;\n"));
+    EXPECT_EQ(execute(scanned, queries), execute(indexed, queries));
+
+    const auto table = indexed.catalog().find_table("t");
+    ASSERT_NE(nullptr, table);
+    const auto chosen = [&](std::string_view where) -> std::string {
+        const std::string input = "DELETE FROM t WHERE " + std::string(where);
+        rdb::parser::Lexer lexer(input);
+        rdb::parser::Parser parser(lexer);
+        const auto parsed = parser.parse_sql_script();
+        const auto& remove = std::get<rdb::parser::DeleteStatement>(
+            parsed.script.statements_.at(0));
+        rdb::engine::Predicate predicate;
+        EXPECT_FALSE(rdb::engine::bind_predicate(
+            *table, *remove.expression(), predicate));
+        const auto* index = rdb::engine::choose_index(*table, predicate);
+        return index == nullptr ? "" : index->name();
+    };
+    EXPECT_EQ("tah", chosen("a = 5;"));
+    EXPECT_EQ("tah", chosen("5.0 != a;"));
+    EXPECT_EQ("ta", chosen("a < 5;"));
+    EXPECT_EQ("ta", chosen("a > 4.5;"));
+    EXPECT_EQ("tb", chosen("b = 1;"));
+    EXPECT_EQ("", chosen("b < 1;"));
+    EXPECT_EQ("", chosen("b = 16777217;"));
+    EXPECT_EQ("tc", chosen("\"s1\" > c;"));
+    EXPECT_EQ("", chosen("a < b;"));
+    EXPECT_EQ("", chosen("a > 3000000000.0;"));
+
+    EXPECT_EQ(
+        "Index 'ta' already exists\n"
+        "No table 'u'\n"
+        "No column 'x'\n"
+        "0\n"
+        "Index 'ta' already exists\n",
+        execute(
+            indexed,
+            "CREATE INDEX ta ON t (b);\n"
+            "CREATE INDEX ua ON u (a);\n"
+            "CREATE INDEX tx ON t (x);\n"
+            "CREATE TABLE u (a INT);\n"
+            "CREATE INDEX ta ON u (a);\n"));
+}
+
+TEST(EngineSuite, ExecuteScriptTest) {
+    rdb::engine::Engine engine;
+    EXPECT_EQ(
+        "0\n"
+        "3\n"
+        "1\n"
+        "1 1.500000 x;2 2.000000 y;3 0.500000 z;4 0.000000 ;\n"
+        "1 x;2 y;\n"
+        "x;\n",
+        execute(
+            engine,
+            "CREATE TABLE t (a INT, b REAL, c TEXT);\n"
+            "INSERT INTO t (a, b, c) VALUES (1, 1.5, \"x\"), (2, 2, \"y\"), "
+            "(3, 0.5, \"z\");\n"
+            "INSERT INTO t (a) VALUES (4);\n"
+            "SELECT a b c FROM t;\n"
+            "SELECT a c FROM t WHERE b > 1.0;\n"
+            "SELECT c FROM t WHERE \"x\" = c;\n"));
+
+    EXPECT_EQ(
+        "3\n"
+        "2;\n"
+        "0\n"
+        "No table 't'\n",
+        execute(
+            engine,
+            "DELETE FROM t WHERE a != b;\n"
+            "SELECT a FROM t;\n"
+            "DROP TABLE t;\n"
+            "SELECT a FROM t;\n"));
+    EXPECT_EQ(0U, engine.catalog().size());
+}
+
+TEST(EngineSuite, ExecutionErrorTest) {
+    rdb::engine::Engine engine;
+    EXPECT_EQ(
+        "0\n"
+        "Table 't' already exists\n"
+        "Duplicate column 'a'\n"
+        "No column 'x'\n"
+        "Duplicate column 'a'\n"
+        "Type mismatch for 'a'\n"
+        "Type mismatch for 'b'\n"
+        "No column 'x'\n"
+        "Type mismatch for 'b'\n"
+        "No table 'u'\n"
+        "No table 'u'\n"
+        "Unbound parameter '$1'\n"
+        "Unbound parameter '$2'\n"
+        "\n",
+        execute(
+            engine,
+            "CREATE TABLE t (a INT, b TEXT);\n"
+            "CREATE TABLE t (a INT);\n"
+            "CREATE TABLE u (a INT, a REAL);\n"
+            "INSERT INTO t (x) VALUES (1);\n"
+            "INSERT INTO t (a, a) VALUES (1, 2);\n"
+            "INSERT INTO t (a) VALUES (1.5);\n"
+            "INSERT INTO t (a, b) VALUES (1, 2);\n"
+            "SELECT x FROM t;\n"
+            "DELETE FROM t WHERE b > 1;\n"
+            "DELETE FROM u;\n"
+            "DROP TABLE u;\n"
+            "INSERT INTO t (a, b) VALUES (1, ?);\n"
+            "SELECT a FROM t WHERE a = $2;\n"
+            "SELECT a b FROM t;\n"));
+}
+
+TEST(EngineSuite, PreparedStatementTest) {
+    rdb::engine::Engine engine;
+    execute(engine, "CREATE TABLE t (a INT, b REAL, c TEXT);");
+
+    const auto insert =
+        rdb::parser::prepare_sql("INSERT INTO t (a, b, c) VALUES (?, ?, ?);");
+    ASSERT_TRUE(insert.statement);
+    const auto select = rdb::parser::prepare_sql(
+        "SELECT a b c FROM t WHERE b >= $1; SELECT a FROM t WHERE c = $2;");
+    ASSERT_TRUE(select.statement);
+
+    for (int32_t i = 0; i < 3; ++i) {
+        const auto script = insert.statement->bind(
+            {i, static_cast<float>(i) / 2, std::string_view("text")});
+        ASSERT_TRUE(script);
+        EXPECT_EQ(1U, engine.execute(*script)[0].rows_affected_);
+    }
+    const auto script =
+        select.statement->bind({0.5F, std::string_view("text")});
+    ASSERT_TRUE(script);
+    const auto results = engine.execute(*script);
+    ASSERT_EQ(2U, results.size());
+    EXPECT_EQ(2U, results[0].result_set_.row_count());
+    EXPECT_EQ(3U, results[1].result_set_.row_count());
+}
+
+TEST(EngineSuite, SnapshotTest) {
+    rdb::engine::Engine engine;
+    execute(
+        engine,
+        "CREATE TABLE t (a INT, c TEXT);\n"
+        "INSERT INTO t (a, c) VALUES (1, \"x\"), (2, \"y\"), (3, \"z\");\n"
+        "CREATE INDEX ta ON t (a) USING BTREE;\n");
+    const auto snapshot = engine.catalog().find_table("t");
+    ASSERT_NE(nullptr, snapshot);
+
+    EXPECT_EQ(
+        "1\n2\n1;\n",
+        execute(
+            engine,
+            "DELETE FROM t WHERE a = 2;\n"
+            "INSERT INTO t (a, c) VALUES (4, \"w\"), (5, \"v\");\n"
+            "SELECT a FROM t WHERE a < 3;\n"));
+    EXPECT_EQ("1;3;4;5;\n", execute(engine, "SELECT a FROM t;"));
+
+    // The version taken before still has its three rows, whether scanned
+    // or looked up in the index the later rows went into.
+    const auto all = rdb::engine::all_rows(*snapshot);
+    EXPECT_EQ((rdb::engine::Selection{0, 1, 2}), all);
+    EXPECT_EQ("y", snapshot->column(1).text(1));
+    rdb::engine::Predicate predicate;
+    predicate.left_.column_ = 0;
+    predicate.left_.type_ = rdb::parser::ColumnDef::Type::Int;
+    predicate.right_.literal_ = int32_t(1);
+    predicate.right_.type_ = rdb::parser::ColumnDef::Type::Int;
+    predicate.operation_ = rdb::parser::Expression::Operation::Rt;
+    predicate.comparison_ = rdb::engine::Predicate::Comparison::Int;
+    EXPECT_EQ(
+        (rdb::engine::Selection{1, 2}),
+        rdb::engine::select_rows(*snapshot, predicate));
+
+    EXPECT_EQ(1U, engine.catalog().find_table("t")->dead_rows());
+    EXPECT_EQ(1U, engine.vacuum());
+    EXPECT_EQ(0U, engine.vacuum());
+    const auto vacuumed = engine.catalog().find_table("t");
+    EXPECT_EQ(4U, vacuumed->row_count());
+    EXPECT_EQ(0U, vacuumed->dead_rows());
+    EXPECT_EQ(
+        "1 x;3 z;4 w;5 v;\n3;4;5;\n",
+        execute(engine, "SELECT a c FROM t; SELECT a FROM t WHERE a > 1;"));
+    EXPECT_EQ(
+        (rdb::engine::Selection{1, 2}),
+        rdb::engine::select_rows(*snapshot, predicate));
+}
+
+TEST(EngineSuite, VacuumCatchUpTest) {
+    rdb::engine::Engine engine;
+    execute(
+        engine,
+        "CREATE TABLE t (a INT, c TEXT);\n"
+        "INSERT INTO t (a, c) VALUES (1, \"a\"), (2, \"b\"), (3, \"c\"), "
+        "(4, \"d\"), (5, \"e\"), (6, \"f\");\n"
+        "CREATE INDEX ta ON t (a) USING HASH;\n"
+        "DELETE FROM t WHERE a < 3;\n");
+
+    // Compacted from a version writers then move past.
+    const auto earlier = engine.catalog().find_table("t");
+    const auto next = earlier->next_version();
+    const auto kept = next->vacuum();
+    EXPECT_EQ((rdb::engine::Selection{2, 3, 4, 5}), kept);
+    execute(
+        engine,
+        "DELETE FROM t WHERE a = 4;\n"
+        "INSERT INTO t (a, c) VALUES (7, \"g\"), (8, \"h\");\n"
+        "DELETE FROM t WHERE a = 7;\n"
+        "CREATE INDEX tc ON t (c) USING BTREE;\n");
+    const auto later = engine.catalog().find_table("t");
+    ASSERT_TRUE(later->extends(*earlier));
+
+    next->catch_up(*earlier, kept, *later);
+    EXPECT_GT(next->version(), later->version());
+    EXPECT_EQ(6U, next->row_count());
+    EXPECT_EQ(2U, next->dead_rows());
+    EXPECT_FALSE(next->extends(*earlier));
+    engine.catalog().publish(next);
+    EXPECT_EQ("3 c;5 e;6 f;8 h;\n", execute(engine, "SELECT a c FROM t;"));
+    // Both indexes hold the rows appended since.
+    EXPECT_EQ(
+        "8;\n8;\n",
+        execute(
+            engine,
+            "SELECT a FROM t WHERE a = 8; SELECT a FROM t WHERE c = \"h\";"));
+
+    EXPECT_EQ(2U, engine.vacuum());
+    EXPECT_EQ(4U, engine.catalog().find_table("t")->row_count());
+    EXPECT_EQ("3 c;5 e;6 f;8 h;\n", execute(engine, "SELECT a c FROM t;"));
+}
+
+TEST(EngineSuite, ConcurrentReadWriteTest) {
+    rdb::engine::Engine engine;
+    execute(
+        engine,
+        "CREATE TABLE t (a INT, b INT);\n"
+        "CREATE INDEX tb ON t (b) USING HASH;\n");
+
+    // Each statement keeps the sum of `a` at zero: pairs (k, k) and
+    // (-k, k) go in together and come out together by `b`.
+    constexpr int32_t pairs = 2000;
+    std::thread writer([&] {
+        for (int32_t k = 1; k <= pairs; ++k) {
+            const std::string key = std::to_string(k);
+            execute(
+                engine,
+                "INSERT INTO t (a, b) VALUES (" + key + ", " + key + "), (-" +
+                    key + ", " + key + ");");
+            if (k % 3 == 0) {
+                execute(
+                    engine,
+                    "DELETE FROM t WHERE b = " + std::to_string(k - 1) + ";");
+            }
+        }
+    });
+    std::thread collector([&] {
+        for (int i = 0; i < 200; ++i) {
+            engine.vacuum();
+            std::this_thread::yield();
+        }
+    });
+
+    const auto select = rdb::parser::prepare_sql(
+        "SELECT a FROM t; SELECT a FROM t WHERE b != 0;");
+    ASSERT_TRUE(select.statement);
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&] {
+            for (int i = 0; i < 300; ++i) {
+                const auto results = engine.execute(select.statement->script());
+                for (const auto& result : results) {
+                    const auto& column = result.result_set_.columns_.at(0);
+                    int64_t sum = 0;
+                    for (size_t row = 0; row < column.size(); ++row) {
+                        sum += column.ints()[row];
+                    }
+                    EXPECT_EQ(0, sum);
+                    EXPECT_EQ(0U, column.size() % 2);
+                }
+            }
+        });
+    }
+    writer.join();
+    collector.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    engine.vacuum();
+    const auto table = engine.catalog().find_table("t");
+    EXPECT_EQ(0U, table->dead_rows());
+    EXPECT_EQ(2U * (pairs - pairs / 3), table->row_count());
+    EXPECT_EQ(
+        "\n4;-4;\n",
+        execute(
+            engine,
+            "SELECT a FROM t WHERE b = 2; SELECT a FROM t WHERE b = 4;"));
+}
+
+TEST(EngineSuite, ThreadPoolTest) {
+    rdb::engine::ThreadPool pool(4);
+    ASSERT_EQ(4U, pool.thread_count());
+
+    // Loops from several threads at once: every morsel runs exactly once,
+    // and a slot never runs two at a time.
+    constexpr size_t morsel_count = 5000;
+    std::vector<std::thread> callers;
+    for (int caller = 0; caller < 3; ++caller) {
+        callers.emplace_back([&] {
+            std::vector<std::atomic<int>> runs(morsel_count);
+            std::vector<std::atomic<int>> busy(pool.thread_count());
+            pool.run(morsel_count, [&](size_t morsel, size_t slot) {
+                EXPECT_EQ(1, ++busy.at(slot));
+                ++runs[morsel];
+                --busy[slot];
+            });
+            EXPECT_TRUE(std::all_of(runs.begin(), runs.end(), [](auto& n) {
+                return n == 1;
+            }));
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    std::atomic<size_t> ran = 0;
+    EXPECT_THROW(
+        pool.run(
+            100,
+            [&](size_t morsel, size_t /*slot*/) {
+                ++ran;
+                if (morsel == 42) {
+                    throw std::runtime_error("morsel 42");
+                }
+            }),
+        std::runtime_error);
+    EXPECT_EQ(100U, ran);
+    pool.run(0, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(EngineSuite, ParallelScanTest) {
+    std::string insert = "INSERT INTO t (a, b, c) VALUES ";
+    for (int32_t i = 0; i < 20000; ++i) {
+        insert += (i == 0 ? "(" : ", (") + std::to_string(i * 7919 % 1000) +
+            ", " + std::to_string(i % 13) + ".5, \"s" +
+            std::to_string(i % 101) + "\")";
+    }
+    const std::string setup =
+        "CREATE TABLE t (a INT, b REAL, c TEXT);\n" + insert +
+        ";\n"
+        "DELETE FROM t WHERE b = 3.5;\n";
+    const std::string queries =
+        "SELECT a b c FROM t;\n"
+        "SELECT a c FROM t WHERE a < 100;\n"
+        "SELECT c FROM t WHERE b >= 7;\n"
+        "SELECT a FROM t WHERE c = \"s5\";\n"
+        "SELECT a FROM t WHERE a = b;\n"
+        "SELECT b FROM t WHERE 1 = 1;\n"
+        "SELECT b FROM t WHERE 1 = 2;\n";
+
+    const auto options = [](size_t threads, bool ordered) {
+        rdb::engine::ScanOptions options;
+        options.threads_ = threads;
+        options.morsel_rows_ = 1000;
+        options.ordered_ = ordered;
+        return options;
+    };
+    rdb::engine::Engine serial(options(1, true));
+    rdb::engine::Engine ordered(options(4, true));
+    rdb::engine::Engine unordered(options(4, false));
+    std::vector<std::string> results;
+    for (auto* engine : {&serial, &ordered, &unordered}) {
+        execute(*engine, setup);
+        results.push_back(execute(*engine, queries));
+    }
+    EXPECT_TRUE(results[0] == results[1]);
+
+    // Unordered results hold the same rows.
+    const auto sorted_rows = [](const std::string& result) {
+        std::vector<std::string> rows;
+        std::stringstream lines(result);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::stringstream cells(line);
+            std::vector<std::string> sorted;
+            std::string row;
+            while (std::getline(cells, row, ';')) {
+                sorted.push_back(row);
+            }
+            std::sort(sorted.begin(), sorted.end());
+            rows.push_back(std::to_string(sorted.size()));
+            rows.insert(rows.end(), sorted.begin(), sorted.end());
+        }
+        return rows;
+    };
+    EXPECT_TRUE(sorted_rows(results[0]) == sorted_rows(results[2]));
+    const std::string all = results[0].substr(0, results[0].find('\n'));
+    EXPECT_EQ(20000 - 1539, std::count(all.begin(), all.end(), ';'));
+}
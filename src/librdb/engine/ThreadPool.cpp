@@ -0,0 +1,183 @@
+#include <librdb/engine/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rdb::engine {
+
+namespace {
+
+// A share of morsels [begin, end), packed into one word so that it can be
+// claimed from with a single compare-and-swap.
+uint64_t pack(uint32_t begin, uint32_t end) {
+    return (uint64_t(begin) << 32) | end;
+}
+
+uint32_t begin_of(uint64_t share) {
+    return static_cast<uint32_t>(share >> 32);
+}
+
+uint32_t end_of(uint64_t share) {
+    return static_cast<uint32_t>(share);
+}
+
+// Takes the first morsel of `share`.
+bool claim(std::atomic<uint64_t>& share, size_t& morsel) {
+    uint64_t current = share.load();
+    while (begin_of(current) < end_of(current)) {
+        const uint32_t begin = begin_of(current);
+        if (share.compare_exchange_weak(
+                current, pack(begin + 1, end_of(current)))) {
+            morsel = begin;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+struct ThreadPool::Loop {
+    Loop(size_t morsel_count, size_t slot_count, const Body& body)
+        : body_(body),
+          morsel_count_(morsel_count),
+          shares_(slot_count),
+          unclaimed_(morsel_count) {
+        for (size_t slot = 0; slot < slot_count; ++slot) {
+            shares_[slot] = pack(
+                static_cast<uint32_t>(slot * morsel_count / slot_count),
+                static_cast<uint32_t>((slot + 1) * morsel_count / slot_count));
+        }
+    }
+
+    // Moves the back half of another slot's share to `slot`, whose own is
+    // empty, and takes its first morsel.
+    bool steal(size_t slot, size_t& morsel) {
+        const size_t slot_count = shares_.size();
+        for (size_t i = 1; i < slot_count; ++i) {
+            auto& victim = shares_[(slot + i) % slot_count];
+            uint64_t current = victim.load();
+            while (begin_of(current) < end_of(current)) {
+                const uint32_t begin = begin_of(current);
+                const uint32_t end = end_of(current);
+                const uint32_t middle = begin + (end - begin) / 2;
+                if (victim.compare_exchange_weak(
+                        current, pack(begin, middle))) {
+                    morsel = middle;
+                    shares_[slot] = pack(middle + 1, end);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    const Body& body_;
+    const size_t morsel_count_;
+    std::vector<std::atomic<uint64_t>> shares_;
+    std::atomic<size_t> unclaimed_;
+    std::atomic<size_t> finished_ = 0;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(thread_count - 1);
+    for (size_t slot = 1; slot < thread_count; ++slot) {
+        workers_.emplace_back([this, slot] { work(slot); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(size_t morsel_count, const Body& body) {
+    assert(morsel_count <= UINT32_MAX);
+    if (morsel_count == 0) {
+        return;
+    }
+    const auto loop =
+        std::make_shared<Loop>(morsel_count, thread_count(), body);
+    if (!workers_.empty()) {
+        {
+            std::lock_guard lock(mutex_);
+            loops_.push_back(loop);
+        }
+        wake_.notify_all();
+    }
+
+    take_part(*loop, 0);
+    {
+        std::unique_lock lock(mutex_);
+        finished_.wait(
+            lock, [&] { return loop->finished_ == loop->morsel_count_; });
+        loops_.erase(
+            std::remove(loops_.begin(), loops_.end(), loop), loops_.end());
+    }
+    if (loop->error_) {
+        std::rethrow_exception(loop->error_);
+    }
+}
+
+void ThreadPool::take_part(Loop& loop, size_t slot) {
+    size_t morsel = 0;
+    while (claim(loop.shares_[slot], morsel) || loop.steal(slot, morsel)) {
+        --loop.unclaimed_;
+        try {
+            loop.body_(morsel, slot);
+        } catch (...) {
+            std::lock_guard lock(loop.error_mutex_);
+            if (!loop.error_) {
+                loop.error_ = std::current_exception();
+            }
+        }
+        if (++loop.finished_ == loop.morsel_count_) {
+            std::lock_guard lock(mutex_);
+            finished_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::work(size_t slot) {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        std::shared_ptr<Loop> loop;
+        wake_.wait(lock, [&] {
+            for (const auto& candidate : loops_) {
+                if (candidate->unclaimed_ > 0) {
+                    loop = candidate;
+                    return true;
+                }
+            }
+            return stopping_;
+        });
+        if (!loop) {
+            return;
+        }
+        lock.unlock();
+        take_part(*loop, slot);
+        loop.reset();
+        lock.lock();
+    }
+}
+
+}  // namespace rdb::engine
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rdb::engine {
+
+// Worker threads that run parallel loops over morsels, small numbered
+// units of work. run() splits the morsels of a loop into one contiguous
+// share per thread. Each thread takes morsels from the front of its share
+// and, once it is empty, steals the back half of another thread's. Owners
+// thus walk their share in order, and steals are rare and big. Claiming a
+// morsel is a compare-and-swap on the share; no lock is taken per morsel.
+//
+// Several threads may call run() at once. Workers help with whichever
+// loops still have morsels, and the shares of workers busy elsewhere get
+// stolen.
+class ThreadPool {
+   public:
+    // Calls body(morsel, slot).
+    using Body = std::function<void(size_t morsel, size_t slot)>;
+
+    // `thread_count` threads run each loop, the one calling run() among
+    // them: one per core if 0.
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t thread_count() const { return workers_.size() + 1; }
+
+    // Calls body(morsel, slot) once for every morsel in [0, morsel_count)
+    // and returns when all calls have. `slot`, below thread_count(), tells
+    // the threads apart: calls with one slot never overlap, so per-slot
+    // state needs no lock. Rethrows the first exception `body` throws,
+    // after the other morsels have run. Must not be called from `body`.
+    void run(size_t morsel_count, const Body& body);
+
+   private:
+    struct Loop;
+
+    // Runs morsels of `loop` as `slot` until none is left to claim.
+    void take_part(Loop& loop, size_t slot);
+    void work(size_t slot);
+
+    std::mutex mutex_;
+    // Signalled when a loop starts and on stopping.
+    std::condition_variable wake_;
+    // Signalled when a loop finishes.
+    std::condition_variable finished_;
+    // Loops being run; workers join those with morsels left to claim.
+    std::vector<std::shared_ptr<Loop>> loops_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace rdb::engine
@@ -0,0 +1,70 @@
+#include <librdb/parser/AstArena.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace rdb::parser {
+
+AstArena::AstArena(AstArena&& other) noexcept
+    : blocks_(std::move(other.blocks_)),
+      cursor_(std::exchange(other.cursor_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)),
+      next_block_size_(
+          std::exchange(other.next_block_size_, first_block_size)),
+      bytes_allocated_(std::exchange(other.bytes_allocated_, 0)) {
+    other.blocks_.clear();
+}
+
+AstArena& AstArena::operator=(AstArena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        other.blocks_.clear();
+        cursor_ = std::exchange(other.cursor_, nullptr);
+        end_ = std::exchange(other.end_, nullptr);
+        next_block_size_ =
+            std::exchange(other.next_block_size_, first_block_size);
+        bytes_allocated_ = std::exchange(other.bytes_allocated_, 0);
+    }
+    return *this;
+}
+
+void* AstArena::allocate(size_t size, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(cursor_);
+    auto aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if ((cursor_ == nullptr) ||
+        (aligned + size > reinterpret_cast<uintptr_t>(end_))) {
+        const size_t block_size = std::max(next_block_size_, size + alignment);
+        // Left uninitialized: make_unique would zero the whole block.
+        blocks_.push_back(
+            {std::unique_ptr<std::byte[]>(new std::byte[block_size]),
+             block_size});
+        cursor_ = blocks_.back().data.get();
+        end_ = cursor_ + block_size;
+        next_block_size_ = std::min(next_block_size_ * 2, max_block_size);
+        bytes_allocated_ += block_size;
+
+        address = reinterpret_cast<uintptr_t>(cursor_);
+        aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+    cursor_ += (aligned - address) + size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void AstArena::splice(AstArena&& other) {
+    blocks_.insert(
+        blocks_.end(),
+        std::make_move_iterator(other.blocks_.begin()),
+        std::make_move_iterator(other.blocks_.end()));
+    bytes_allocated_ += other.bytes_allocated_;
+    other.blocks_.clear();
+    other.cursor_ = nullptr;
+    other.end_ = nullptr;
+    other.next_block_size_ = first_block_size;
+    other.bytes_allocated_ = 0;
+}
+
+}  // namespace rdb::parser
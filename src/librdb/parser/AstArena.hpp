@@ -0,0 +1,75 @@
+#pragma once
+
+#include <librdb/parser/Span.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rdb::parser {
+
+// Monotonic allocator for statements and their child lists. Objects are
+// never destroyed one by one: the arena releases whole blocks at once, so
+// only trivially destructible types may be placed in it.
+class AstArena {
+   public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+    // Leave `other` empty, ready to allocate blocks of its own.
+    AstArena(AstArena&& other) noexcept;
+    AstArena& operator=(AstArena&& other) noexcept;
+    ~AstArena() = default;
+
+    void* allocate(size_t size, size_t alignment);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        void* memory = allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    Span<const T> copy(Span<const T> items) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (items.empty()) {
+            return {};
+        }
+        T* data = static_cast<T*>(
+            allocate(sizeof(T) * items.size(), alignof(T)));
+        std::uninitialized_copy(items.begin(), items.end(), data);
+        return {data, items.size()};
+    }
+
+    template <typename T>
+    Span<const T> copy(const std::vector<T>& items) {
+        return copy(Span<const T>(items.data(), items.size()));
+    }
+
+    // Takes over the blocks of `other`; everything allocated there stays
+    // valid and is now owned by this arena.
+    void splice(AstArena&& other);
+
+    size_t bytes_allocated() const { return bytes_allocated_; }
+
+   private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t first_block_size = 4096;
+    static constexpr size_t max_block_size = size_t(1) << 20;
+
+    std::vector<Block> blocks_;
+    std::byte* cursor_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t next_block_size_ = first_block_size;
+    size_t bytes_allocated_ = 0;
+};
+
+}  // namespace rdb::parser
@@ -0,0 +1,357 @@
+#include <librdb/parser/BinaryScript.hpp>
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/OutputBuffer.hpp>
+#include <librdb/parser/ParallelParser.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/StatementCache.hpp>
+#include <librdb/parser/StreamParser.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+enum class ScriptKind {
+    Create,
+    Select,
+    Insert,
+    BulkInsert,
+    Delete,
+    Drop,
+    Mixed,
+    Errors,
+};
+
+struct GeneratedScript {
+    ScriptKind kind = ScriptKind::Mixed;
+    size_t size = 0;
+    std::string text;
+    size_t statements = 0;
+};
+
+void append_statement(std::string& out, ScriptKind kind, size_t i) {
+    const std::string n = std::to_string(i);
+    const std::string table = "t" + std::to_string(i % 16);
+    switch (kind) {
+        case ScriptKind::Create:
+            out += "CREATE TABLE " + table + " (id INT, price REAL, " +
+                "name TEXT);\n";
+            return;
+        case ScriptKind::Select:
+            if (i % 2 == 0) {
+                out += "SELECT id price name FROM " + table + ";\n";
+            } else {
+                out += "SELECT id name FROM " + table + " WHERE id <= " + n +
+                    ";\n";
+            }
+            return;
+        case ScriptKind::Insert:
+            out += "INSERT INTO " + table + " (id, price, name) VALUES (" +
+                n + ", " + n + ".25, \"name" + n + "\");\n";
+            return;
+        case ScriptKind::BulkInsert: {
+            const size_t rows = 64;
+            out += "INSERT INTO " + table + " (id, price, name) VALUES ";
+            for (size_t row = 0; row < rows; ++row) {
+                const std::string id = std::to_string(i * rows + row);
+                out += (row == 0 ? "(" : ", (") + id + ", " + id +
+                    ".25, \"name" + id + "\")";
+            }
+            out += ";\n";
+            return;
+        }
+        case ScriptKind::Delete:
+            out += "DELETE FROM " + table + " WHERE id = " + n + ";\n";
+            return;
+        case ScriptKind::Drop:
+            out += "DROP TABLE " + table + ";\n";
+            return;
+        case ScriptKind::Mixed: {
+            const ScriptKind kinds[] = {
+                ScriptKind::Create,
+                ScriptKind::Insert,
+                ScriptKind::Insert,
+                ScriptKind::Select,
+                ScriptKind::Delete,
+                ScriptKind::Drop,
+            };
+            append_statement(out, kinds[i % std::size(kinds)], i);
+            return;
+        }
+        case ScriptKind::Errors:
+            switch (i % 4) {
+                case 0:
+                    append_statement(out, ScriptKind::Insert, i);
+                    return;
+                case 1:
+                    out += "INSERT INTO " + table + " VALUES (" + n + ");\n";
+                    return;
+                case 2:
+                    out += "SELEST id FROM " + table + " WHERE id ! 1;\n";
+                    return;
+                default:
+                    out += "DROP TABLE " + n + ";\n";
+                    return;
+            }
+    }
+}
+
+// Benchmarks run one argument set at a time, so caching the last script is
+// enough to keep generation of the large inputs out of repeated runs.
+const GeneratedScript& generate_script(ScriptKind kind, size_t size) {
+    static GeneratedScript script;
+    if ((script.kind == kind) && (script.size == size)) {
+        return script;
+    }
+
+    script.kind = kind;
+    script.size = size;
+    script.text.clear();
+    script.text.reserve(size + 256);
+    script.statements = 0;
+    while (script.text.size() < size) {
+        append_statement(script.text, kind, script.statements);
+        ++script.statements;
+    }
+    return script;
+}
+
+void set_counters(benchmark::State& state, const GeneratedScript& script) {
+    const auto iterations = static_cast<int64_t>(state.iterations());
+    state.SetBytesProcessed(
+        iterations * static_cast<int64_t>(script.text.size()));
+    state.counters["statements/s"] = benchmark::Counter(
+        static_cast<double>(script.statements) *
+            static_cast<double>(iterations),
+        benchmark::Counter::kIsRate);
+}
+
+void BM_LexerGet(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    size_t tokens = 0;
+    for (auto _ : state) {
+        rdb::parser::Lexer lexer(script.text);
+        tokens = 0;
+        while (lexer.get().type() != rdb::parser::Token::Kind::Eof) {
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    set_counters(state, script);
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+
+// Mirrors the parser's access pattern: every token is peeked before it is
+// consumed.
+void BM_LexerPeek(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    size_t tokens = 0;
+    for (auto _ : state) {
+        rdb::parser::Lexer lexer(script.text);
+        tokens = 0;
+        while (lexer.peek().type() != rdb::parser::Token::Kind::Eof) {
+            benchmark::DoNotOptimize(lexer.peek());
+            lexer.get();
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    set_counters(state, script);
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+
+void BM_LexerTokenizeAll(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    size_t tokens = 0;
+    for (auto _ : state) {
+        rdb::parser::Lexer lexer(script.text);
+        const auto buffer = lexer.tokenize_all();
+        tokens = buffer.size() - 1;
+        benchmark::DoNotOptimize(tokens);
+    }
+    set_counters(state, script);
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+
+void BM_ParseScript(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    size_t errors = 0;
+    for (auto _ : state) {
+        rdb::parser::Lexer lexer(script.text);
+        rdb::parser::Parser parser(lexer);
+        const auto result = parser.parse_sql_script();
+        errors = result.errors_.size();
+        benchmark::DoNotOptimize(result.script.statements_.data());
+    }
+    set_counters(state, script);
+    state.counters["errors"] = static_cast<double>(errors);
+}
+
+void BM_ParseScriptParallel(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        const auto result =
+            rdb::parser::parse_sql_script_parallel(script.text);
+        benchmark::DoNotOptimize(result.script.statements_.data());
+    }
+    set_counters(state, script);
+}
+
+void BM_ParseStream(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    size_t statements = 0;
+    for (auto _ : state) {
+        std::istringstream stream(script.text);
+        statements = 0;
+        rdb::parser::parse_sql_stream(
+            stream, [&](rdb::parser::Parser::Result result) {
+                statements += result.script.statements_.size();
+            });
+        benchmark::DoNotOptimize(statements);
+    }
+    set_counters(state, script);
+}
+
+// Reads the script back from its binary form instead of parsing the text.
+// Bytes are counted in script text, to compare with BM_ParseScript.
+void BM_ReadBinaryScript(benchmark::State& state, ScriptKind kind) {
+    const auto& script =
+        generate_script(kind, static_cast<size_t>(state.range(0)));
+    rdb::parser::Lexer lexer(script.text);
+    rdb::parser::Parser parser(lexer);
+    const auto source = rdb::parser::ScriptSource::from_text(
+        rdb::parser::write_binary_script(parser.parse_sql_script().script));
+    for (auto _ : state) {
+        const auto result = rdb::parser::read_binary_script(source);
+        benchmark::DoNotOptimize(result->statements_.data());
+    }
+    set_counters(state, script);
+    state.counters["binary_bytes"] =
+        static_cast<double>(source->text().size());
+}
+
+// Prints every statement of the script, either through to_string() or
+// appending to one reused OutputBuffer.
+void BM_FormatScript(benchmark::State& state, bool reuse_buffer) {
+    const auto& script = generate_script(
+        ScriptKind::Mixed, static_cast<size_t>(state.range(0)));
+    rdb::parser::Lexer lexer(script.text);
+    rdb::parser::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    rdb::parser::OutputBuffer out;
+    for (auto _ : state) {
+        for (const auto& statement : result.script.statements_) {
+            if (reuse_buffer) {
+                out.clear();
+                rdb::parser::format_to(out, statement);
+                benchmark::DoNotOptimize(out.view().data());
+            } else {
+                const std::string text = rdb::parser::to_string(statement);
+                benchmark::DoNotOptimize(text.data());
+            }
+        }
+    }
+    set_counters(state, script);
+}
+
+// Parses each line of the script as a separate input, the way an
+// application sends statements one by one.
+void BM_ParseStatements(benchmark::State& state, bool cached) {
+    const auto& script = generate_script(
+        ScriptKind::Mixed, static_cast<size_t>(state.range(0)));
+    std::vector<std::string_view> lines;
+    const std::string_view text = script.text;
+    for (size_t begin = 0; begin < text.size();) {
+        const size_t end = text.find('\n', begin);
+        lines.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+
+    for (auto _ : state) {
+        rdb::parser::StatementCache cache;
+        for (const auto line : lines) {
+            if (cached) {
+                const auto result = cache.parse(line);
+                benchmark::DoNotOptimize(result.script.statements_.data());
+            } else {
+                rdb::parser::Lexer lexer(line);
+                rdb::parser::Parser parser(lexer);
+                const auto result = parser.parse_sql_script();
+                benchmark::DoNotOptimize(result.script.statements_.data());
+            }
+        }
+    }
+    set_counters(state, script);
+}
+
+void script_sizes(benchmark::internal::Benchmark* benchmark) {
+    const int64_t kb = 1 << 10;
+    const int64_t gb = 1 << 30;
+    const int multiplier = 32;
+    benchmark->RangeMultiplier(multiplier)
+        ->Range(kb, gb)
+        ->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_LexerGet, mixed, ScriptKind::Mixed)->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_LexerGet, insert, ScriptKind::Insert)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_LexerPeek, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_LexerTokenizeAll, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes);
+
+BENCHMARK_CAPTURE(BM_ParseScript, create, ScriptKind::Create)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, select, ScriptKind::Select)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, insert, ScriptKind::Insert)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, bulk_insert, ScriptKind::BulkInsert)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, delete, ScriptKind::Delete)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, drop, ScriptKind::Drop)->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseScript, errors, ScriptKind::Errors)
+    ->Apply(script_sizes);
+
+BENCHMARK_CAPTURE(BM_ParseScriptParallel, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ParseScriptParallel, insert, ScriptKind::Insert)
+    ->Apply(script_sizes)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_ParseStream, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes);
+
+BENCHMARK_CAPTURE(BM_ReadBinaryScript, mixed, ScriptKind::Mixed)
+    ->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ReadBinaryScript, bulk_insert, ScriptKind::BulkInsert)
+    ->Apply(script_sizes);
+
+BENCHMARK_CAPTURE(BM_FormatScript, to_string, false)->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_FormatScript, format_to, true)->Apply(script_sizes);
+
+BENCHMARK_CAPTURE(BM_ParseStatements, uncached, false)->Apply(script_sizes);
+BENCHMARK_CAPTURE(BM_ParseStatements, cached, true)->Apply(script_sizes);
+
+BENCHMARK_MAIN();
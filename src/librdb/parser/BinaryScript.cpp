@@ -0,0 +1,590 @@
+#include <librdb/parser/BinaryScript.hpp>
+
+#include <librdb/parser/AstArena.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Span.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define RDB_BINARY_SCRIPT_IN_PLACE 1
+#endif
+
+namespace rdb::parser {
+
+namespace {
+
+constexpr std::string_view magic = "RDBS";
+constexpr size_t word_size = sizeof(uint32_t);
+// Magic, version, statement count, parameter count, string table offset
+// and size.
+constexpr size_t header_size = 6 * word_size;
+
+enum class StatementTag : uint32_t {
+    CreateTable,
+    Select,
+    Insert,
+    Delete,
+    DropTable,
+    CreateIndex,
+};
+
+// Column only appears in operands.
+enum class ValueTag : uint32_t {
+    Int,
+    Real,
+    Text,
+    Parameter,
+    Column,
+};
+
+// How an INSERT column is stored: a typed array, or Values for a column
+// with parameters.
+enum class ColumnTag : uint32_t {
+    Int,
+    Real,
+    Text,
+    Values,
+};
+
+uint32_t load_word(const char* data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+        (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+void store_word(std::string& out, uint32_t word) {
+    const char bytes[] = {
+        static_cast<char>(word & 0xff),
+        static_cast<char>((word >> 8) & 0xff),
+        static_cast<char>((word >> 16) & 0xff),
+        static_cast<char>((word >> 24) & 0xff),
+    };
+    out.append(bytes, word_size);
+}
+
+template <typename T>
+uint32_t to_bits(T value) {
+    static_assert(sizeof(T) == word_size);
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, word_size);
+    return bits;
+}
+
+template <typename T>
+T from_bits(uint32_t bits) {
+    static_assert(sizeof(T) == word_size);
+    T value;
+    std::memcpy(&value, &bits, word_size);
+    return value;
+}
+
+uint32_t narrow(size_t size) {
+    assert(size <= std::numeric_limits<uint32_t>::max());
+    return static_cast<uint32_t>(size);
+}
+
+class Writer {
+   public:
+    std::string finish(const Script& script) {
+        std::string out;
+        out.reserve(header_size + body_.size() + strings_.size());
+        out += magic;
+        store_word(out, binary_script_version);
+        store_word(out, narrow(script.statements_.size()));
+        store_word(out, narrow(script.parameter_count_));
+        store_word(out, narrow(header_size + body_.size()));
+        store_word(out, narrow(strings_.size()));
+        out += body_;
+        out += strings_;
+        return out;
+    }
+
+    void statement(const Statement& statement) {
+        std::visit(
+            Overloaded{
+                [&](const CreateTableStatement& create) {
+                    tag(StatementTag::CreateTable);
+                    string(create.table_name());
+                    word(narrow(create.column_defs().size()));
+                    for (const auto& column_def : create.column_defs()) {
+                        string(column_def.column_name_);
+                        word(static_cast<uint32_t>(column_def.type_));
+                    }
+                },
+                [&](const SelectStatement& select) {
+                    tag(StatementTag::Select);
+                    names(select.column_names());
+                    string(select.table_name());
+                    expression(select.expression());
+                },
+                [&](const InsertStatement& insert) {
+                    tag(StatementTag::Insert);
+                    string(insert.table_name());
+                    names(insert.column_names());
+                    word(narrow(insert.row_count()));
+                    for (const auto& column : insert.columns()) {
+                        value_column(column, insert.row_count());
+                    }
+                },
+                [&](const DeleteStatement& remove) {
+                    tag(StatementTag::Delete);
+                    string(remove.table_name());
+                    expression(remove.expression());
+                },
+                [&](const DropTableStatement& drop) {
+                    tag(StatementTag::DropTable);
+                    string(drop.table_name());
+                },
+                [&](const CreateIndexStatement& create) {
+                    tag(StatementTag::CreateIndex);
+                    string(create.index_name());
+                    string(create.table_name());
+                    string(create.column_name());
+                    tag(create.method());
+                },
+            },
+            statement);
+    }
+
+   private:
+    void word(uint32_t word) { store_word(body_, word); }
+
+    template <typename Tag>
+    void tag(Tag tag) {
+        word(static_cast<uint32_t>(tag));
+    }
+
+    // Every distinct string is stored once; `text` must outlive the writer.
+    void string(std::string_view text) {
+        const auto [it, inserted] =
+            offsets_.try_emplace(text, narrow(strings_.size()));
+        if (inserted) {
+            strings_ += text;
+        }
+        word(it->second);
+        word(narrow(text.size()));
+    }
+
+    void names(Span<const std::string_view> names) {
+        word(narrow(names.size()));
+        for (const auto name : names) {
+            string(name);
+        }
+    }
+
+    void value(const Value& value) {
+        if (const auto* number = std::get_if<int32_t>(&value)) {
+            tag(ValueTag::Int);
+            word(to_bits(*number));
+        } else if (const auto* number = std::get_if<float>(&value)) {
+            tag(ValueTag::Real);
+            word(to_bits(*number));
+        } else if (const auto* text = std::get_if<std::string_view>(&value)) {
+            tag(ValueTag::Text);
+            string(*text);
+        } else {
+            tag(ValueTag::Parameter);
+            word(std::get<Parameter>(value).index_);
+        }
+    }
+
+    void operand(const Expression::Operand& operand) {
+        if (const auto* name = std::get_if<std::string_view>(&operand)) {
+            tag(ValueTag::Column);
+            string(*name);
+        } else {
+            value(std::get<Value>(operand));
+        }
+    }
+
+    void expression(const std::optional<Expression>& expression) {
+        word(expression ? 1 : 0);
+        if (expression) {
+            operand(expression->left_);
+            word(static_cast<uint32_t>(expression->operation_));
+            operand(expression->right_);
+        }
+    }
+
+    void value_column(const ValueColumn& column, size_t row_count) {
+        if (column.has_parameters()) {
+            tag(ColumnTag::Values);
+            for (const auto& item : column.values_) {
+                value(item);
+            }
+            return;
+        }
+        switch (column.type_) {
+            case ColumnDef::Type::Int:
+                tag(ColumnTag::Int);
+                for (size_t row = 0; row < row_count; ++row) {
+                    word(to_bits(column.ints_[row]));
+                }
+                break;
+            case ColumnDef::Type::Real:
+                tag(ColumnTag::Real);
+                for (size_t row = 0; row < row_count; ++row) {
+                    word(to_bits(column.reals_[row]));
+                }
+                break;
+            case ColumnDef::Type::Text:
+                tag(ColumnTag::Text);
+                for (size_t row = 0; row < row_count; ++row) {
+                    string(column.texts_[row]);
+                }
+                break;
+        }
+    }
+
+    std::string body_;
+    std::string strings_;
+    std::unordered_map<std::string_view, uint32_t> offsets_;
+};
+
+// Reads statements from the body, checking every count, tag and string
+// against the buffer. After the first error it only returns empty results
+// and failed() is set.
+class Reader {
+   public:
+    Reader(
+        std::string_view body,
+        std::string_view strings,
+        size_t parameter_count,
+        AstArena& arena)
+        : body_(body),
+          strings_(strings),
+          parameter_count_(parameter_count),
+          arena_(arena) {}
+
+    bool failed() const { return failed_; }
+    bool at_end() const { return offset_ == body_.size(); }
+    size_t remaining_words() const {
+        return (body_.size() - offset_) / word_size;
+    }
+
+    std::optional<Statement> statement() {
+        switch (tag(StatementTag::CreateIndex)) {
+            case StatementTag::CreateTable: {
+                const auto table_name = string();
+                const size_t n_columns = count(3);
+                column_defs_.clear();
+                for (size_t i = 0; i < n_columns; ++i) {
+                    const auto column_name = string();
+                    const auto type = tag(ColumnDef::Type::Text);
+                    column_defs_.push_back({column_name, type});
+                }
+                if (failed_) {
+                    return std::nullopt;
+                }
+                return CreateTableStatement(
+                    table_name, arena_.copy(column_defs_));
+            }
+            case StatementTag::Select: {
+                const auto column_names = names();
+                const auto table_name = string();
+                const auto where = expression();
+                if (failed_) {
+                    return std::nullopt;
+                }
+                return SelectStatement(
+                    column_names, table_name, where);
+            }
+            case StatementTag::Insert:
+                return insert();
+            case StatementTag::Delete: {
+                const auto table_name = string();
+                const auto where = expression();
+                if (failed_) {
+                    return std::nullopt;
+                }
+                return DeleteStatement(table_name, where);
+            }
+            case StatementTag::DropTable: {
+                const auto table_name = string();
+                if (failed_) {
+                    return std::nullopt;
+                }
+                return DropTableStatement(table_name);
+            }
+            case StatementTag::CreateIndex: {
+                const auto index_name = string();
+                const auto table_name = string();
+                const auto column_name = string();
+                const auto method = tag(CreateIndexStatement::Method::BTree);
+                if (failed_) {
+                    return std::nullopt;
+                }
+                return CreateIndexStatement(
+                    index_name, table_name, column_name, method);
+            }
+        }
+        return std::nullopt;
+    }
+
+   private:
+    void fail() {
+        failed_ = true;
+        offset_ = body_.size();
+    }
+
+    uint32_t word() {
+        if (remaining_words() == 0) {
+            fail();
+            return 0;
+        }
+        const uint32_t word = load_word(body_.data() + offset_);
+        offset_ += word_size;
+        return word;
+    }
+
+    // A tag no greater than `last`.
+    template <typename Tag>
+    Tag tag(Tag last) {
+        const uint32_t word = this->word();
+        if (word > static_cast<uint32_t>(last)) {
+            fail();
+            return Tag{};
+        }
+        return static_cast<Tag>(word);
+    }
+
+    // A non-zero number of items of at least `item_words` words each that
+    // still fit in the body, so that corrupt counts cannot make the
+    // reader allocate more than the buffer holds.
+    size_t count(size_t item_words) {
+        const uint32_t count = word();
+        if ((count == 0) || (count > remaining_words() / item_words)) {
+            fail();
+            return 0;
+        }
+        return count;
+    }
+
+    std::string_view string() {
+        const uint32_t offset = word();
+        const uint32_t size = word();
+        if ((offset > strings_.size()) || (size > strings_.size() - offset)) {
+            fail();
+            return {};
+        }
+        return strings_.substr(offset, size);
+    }
+
+    Span<const std::string_view> names() {
+        const size_t n_names = count(2);
+        names_.clear();
+        for (size_t i = 0; i < n_names; ++i) {
+            names_.push_back(string());
+        }
+        return arena_.copy(names_);
+    }
+
+    Value value(ValueTag tag) {
+        switch (tag) {
+            case ValueTag::Int:
+                return from_bits<int32_t>(word());
+            case ValueTag::Real:
+                return from_bits<float>(word());
+            case ValueTag::Text:
+                return string();
+            case ValueTag::Parameter: {
+                const uint32_t index = word();
+                if (index >= parameter_count_) {
+                    fail();
+                }
+                return Parameter{index};
+            }
+            case ValueTag::Column:
+                break;
+        }
+        fail();
+        return 0;
+    }
+
+    Expression::Operand operand() {
+        const ValueTag tag = this->tag(ValueTag::Column);
+        if (tag == ValueTag::Column) {
+            return string();
+        }
+        return value(tag);
+    }
+
+    std::optional<Expression> expression() {
+        const uint32_t has_expression = word();
+        if (has_expression == 0) {
+            return std::nullopt;
+        }
+        if (has_expression != 1) {
+            fail();
+            return std::nullopt;
+        }
+        const auto left = operand();
+        const auto operation = tag(Expression::Operation::Neq);
+        const auto right = operand();
+        return Expression{left, operation, right};
+    }
+
+    // `count` words of T, in place when the host and alignment allow it.
+    template <typename T>
+    Span<const T> array(size_t count) {
+        const char* data = body_.data() + offset_;
+#ifdef RDB_BINARY_SCRIPT_IN_PLACE
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+            offset_ += count * word_size;
+            return {reinterpret_cast<const T*>(data), count};
+        }
+#endif
+        T* items =
+            static_cast<T*>(arena_.allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = from_bits<T>(load_word(data + i * word_size));
+        }
+        offset_ += count * word_size;
+        return {items, count};
+    }
+
+    std::optional<Statement> insert() {
+        const auto table_name = string();
+        const auto column_names = names();
+        // Each column holds at least a tag and a word per row.
+        const size_t row_count =
+            count(std::max<size_t>(column_names.size(), 1));
+        value_columns_.clear();
+        for (size_t column = 0; column < column_names.size(); ++column) {
+            ValueColumn value_column{ColumnDef::Type::Int, {}, {}, {}, {}};
+            const auto tag = this->tag(ColumnTag::Values);
+            if (failed_ || (row_count > remaining_words())) {
+                fail();
+                return std::nullopt;
+            }
+            switch (tag) {
+                case ColumnTag::Int:
+                    value_column.ints_ = array<int32_t>(row_count);
+                    break;
+                case ColumnTag::Real:
+                    value_column.type_ = ColumnDef::Type::Real;
+                    value_column.reals_ = array<float>(row_count);
+                    break;
+                case ColumnTag::Text:
+                    value_column.type_ = ColumnDef::Type::Text;
+                    texts_.clear();
+                    for (size_t row = 0; row < row_count; ++row) {
+                        texts_.push_back(string());
+                    }
+                    value_column.texts_ = arena_.copy(texts_);
+                    break;
+                case ColumnTag::Values: {
+                    values_.clear();
+                    bool has_parameter = false;
+                    for (size_t row = 0; row < row_count; ++row) {
+                        values_.push_back(
+                            value(this->tag(ValueTag::Parameter)));
+                        has_parameter = has_parameter ||
+                            std::holds_alternative<Parameter>(values_.back());
+                    }
+                    if (!has_parameter) {
+                        fail();
+                    }
+                    value_column.values_ = arena_.copy(values_);
+                    break;
+                }
+            }
+            value_columns_.push_back(value_column);
+        }
+        if (failed_) {
+            return std::nullopt;
+        }
+        return InsertStatement(
+            table_name, column_names, arena_.copy(value_columns_), row_count);
+    }
+
+    std::string_view body_;
+    std::string_view strings_;
+    size_t offset_ = 0;
+    bool failed_ = false;
+    const size_t parameter_count_;
+    AstArena& arena_;
+    // Scratch lists reused by every statement before they are copied into
+    // the arena.
+    std::vector<ColumnDef> column_defs_;
+    std::vector<std::string_view> names_;
+    std::vector<std::string_view> texts_;
+    std::vector<Value> values_;
+    std::vector<ValueColumn> value_columns_;
+};
+
+}  // namespace
+
+std::string write_binary_script(const Script& script) {
+    Writer writer;
+    for (const auto& statement : script.statements_) {
+        writer.statement(statement);
+    }
+    return writer.finish(script);
+}
+
+std::optional<Script> read_binary_script(
+    std::shared_ptr<const ScriptSource> source) {
+    const std::string_view buffer = source->text();
+    if ((buffer.size() < header_size) ||
+        (buffer.substr(0, magic.size()) != magic)) {
+        return std::nullopt;
+    }
+    const auto header = [&](size_t field) {
+        return load_word(buffer.data() + (field + 1) * word_size);
+    };
+    const uint32_t version = header(0);
+    const uint32_t statement_count = header(1);
+    const uint32_t parameter_count = header(2);
+    const uint32_t strings_offset = header(3);
+    const uint32_t strings_size = header(4);
+    if ((version != binary_script_version) || (strings_offset < header_size) ||
+        ((strings_offset - header_size) % word_size != 0) ||
+        (strings_offset > buffer.size()) ||
+        (buffer.size() - strings_offset != strings_size)) {
+        return std::nullopt;
+    }
+
+    Script script;
+    Reader reader(
+        buffer.substr(header_size, strings_offset - header_size),
+        buffer.substr(strings_offset),
+        parameter_count,
+        script.arena_);
+    // The smallest statement, DROP TABLE, takes three words.
+    if (statement_count > reader.remaining_words() / 3) {
+        return std::nullopt;
+    }
+    script.statements_.reserve(statement_count);
+    for (uint32_t i = 0; i < statement_count; ++i) {
+        auto statement = reader.statement();
+        if (!statement) {
+            return std::nullopt;
+        }
+        script.statements_.push_back(std::move(*statement));
+    }
+    if (!reader.at_end()) {
+        return std::nullopt;
+    }
+    script.parameter_count_ = parameter_count;
+    script.source_ = std::move(source);
+    return script;
+}
+
+}  // namespace rdb::parser
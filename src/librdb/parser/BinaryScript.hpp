@@ -0,0 +1,36 @@
+#pragma once
+
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace rdb::parser {
+
+// Bumped whenever the layout below changes; readers reject other versions.
+inline constexpr uint32_t binary_script_version = 2;
+
+// Serializes `script` into one flat buffer of little-endian u32 words:
+//
+//   header   "RDBS", version, statement count, parameter count, string
+//            table offset and string table size
+//   body     the statements, each starting with its kind
+//   strings  every distinct identifier and TEXT lexeme, once
+//
+// Strings are stored as (offset, size) into the table. INT and REAL INSERT
+// columns are stored as plain arrays, so that they can be read in place.
+std::string write_binary_script(const Script& script);
+
+// Reads a buffer written by write_binary_script(), e.g. a mapped file,
+// without copying its payload: identifiers, TEXT values and, on
+// little-endian hosts, INT and REAL INSERT columns point into `source`,
+// which the Script keeps alive. Only the statements and their lists of
+// names are built. std::nullopt if the buffer is truncated, malformed or
+// of another version.
+std::optional<Script> read_binary_script(
+    std::shared_ptr<const ScriptSource> source);
+
+}  // namespace rdb::parser
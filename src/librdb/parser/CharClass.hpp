@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace rdb::parser {
+
+// What a byte can start (or continue) in the lexer's grammar. Matches the
+// "C" locale <cctype> classification for ASCII; every byte >= 0x80 is Other.
+enum class CharClass : uint8_t {
+    Other,
+    Space,
+    Alpha,
+    Digit,
+    Sign,
+    Quote,
+    Param,
+    Operation,
+    Semicolon,
+    Comma,
+    LParen,
+    RParen,
+};
+
+namespace detail {
+
+constexpr std::array<CharClass, 256> make_char_classes() {
+    std::array<CharClass, 256> classes{};
+    for (auto& char_class : classes) {
+        char_class = CharClass::Other;
+    }
+    for (const char c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Space;
+    }
+    for (char c = 'a'; c <= 'z'; ++c) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Alpha;
+    }
+    for (char c = 'A'; c <= 'Z'; ++c) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Alpha;
+    }
+    for (char c = '0'; c <= '9'; ++c) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Digit;
+    }
+    for (const char c : {'<', '>', '=', '!'}) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Operation;
+    }
+    classes['-'] = CharClass::Sign;
+    classes['+'] = CharClass::Sign;
+    classes['"'] = CharClass::Quote;
+    classes['?'] = CharClass::Param;
+    classes['$'] = CharClass::Param;
+    classes[';'] = CharClass::Semicolon;
+    classes[','] = CharClass::Comma;
+    classes['('] = CharClass::LParen;
+    classes[')'] = CharClass::RParen;
+    return classes;
+}
+
+inline constexpr std::array<CharClass, 256> char_classes = make_char_classes();
+
+}  // namespace detail
+
+constexpr CharClass char_class(char c) {
+    return detail::char_classes[static_cast<unsigned char>(c)];
+}
+
+constexpr bool is_space(char c) {
+    return char_class(c) == CharClass::Space;
+}
+
+constexpr bool is_digit(char c) {
+    return char_class(c) == CharClass::Digit;
+}
+
+constexpr bool is_alnum(char c) {
+    const CharClass cls = char_class(c);
+    return (cls == CharClass::Alpha) || (cls == CharClass::Digit);
+}
+
+}  // namespace rdb::parser
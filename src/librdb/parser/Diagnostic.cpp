@@ -0,0 +1,102 @@
+#include <librdb/parser/Diagnostic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace rdb::parser {
+
+namespace {
+
+struct NamedKindSet {
+    TokenKindSet kinds;
+    std::string_view name;
+};
+
+const NamedKindSet named_kind_sets[] = {
+    {{Token::Kind::KwCreate,
+      Token::Kind::KwSelect,
+      Token::Kind::KwInsert,
+      Token::Kind::KwDelete,
+      Token::Kind::KwDrop},
+     "CREATE, SELECT, INSERT, DELETE or DROP"},
+    {{Token::Kind::KwInt, Token::Kind::KwReal, Token::Kind::KwText},
+     "INT, REAL or TEXT"},
+    {{Token::Kind::KwTable, Token::Kind::KwIndex}, "TABLE or INDEX"},
+    {{Token::Kind::KwHash, Token::Kind::KwBtree}, "HASH or BTREE"},
+    {{Token::Kind::Int,
+      Token::Kind::Real,
+      Token::Kind::Text,
+      Token::Kind::Param},
+     "value"},
+    {{Token::Kind::Id,
+      Token::Kind::Int,
+      Token::Kind::Real,
+      Token::Kind::Text,
+      Token::Kind::Param},
+     "operand"},
+    {{Token::Kind::Lte,
+      Token::Kind::Rte,
+      Token::Kind::Neq,
+      Token::Kind::Lt,
+      Token::Kind::Rt,
+      Token::Kind::Eq},
+     "opration"},
+};
+
+void print_expected(std::ostream& os, TokenKindSet expected) {
+    for (const auto& named : named_kind_sets) {
+        if (named.kinds == expected) {
+            os << named.name;
+            return;
+        }
+    }
+
+    const auto last_kind = static_cast<uint8_t>(Token::Kind::Unknown);
+    size_t printed = 0;
+    size_t left = 0;
+    for (uint8_t i = 0; i <= last_kind; ++i) {
+        left += expected.contains(static_cast<Token::Kind>(i)) ? 1 : 0;
+    }
+    for (uint8_t i = 0; i <= last_kind; ++i) {
+        const auto kind = static_cast<Token::Kind>(i);
+        if (!expected.contains(kind)) {
+            continue;
+        }
+        if (printed > 0) {
+            os << (printed + 1 == left ? " or " : ", ");
+        }
+        os << kind_to_str(kind);
+        ++printed;
+    }
+}
+
+}  // namespace
+
+std::string Diagnostic::to_string() const {
+    std::stringstream out;
+    out << *this;
+    return out.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const Diagnostic& diagnostic) {
+    switch (diagnostic.kind_) {
+        case Diagnostic::Kind::UnexpectedToken:
+            os << "Expected ";
+            print_expected(os, diagnostic.expected_);
+            os << ", got " << kind_to_str(diagnostic.got_) << " '"
+               << diagnostic.lexeme_ << "' ";
+            break;
+        case Diagnostic::Kind::ValueOutOfRange:
+            os << kind_to_str(diagnostic.got_) << " out of range '"
+               << diagnostic.lexeme_ << "' ";
+            break;
+    }
+    os << diagnostic.location_.rows() << ":" << diagnostic.location_.cols();
+    return os;
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/Token.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace rdb::parser {
+
+class TokenKindSet {
+   public:
+    constexpr TokenKindSet() = default;
+    constexpr TokenKindSet(std::initializer_list<Token::Kind> kinds) {
+        for (const Token::Kind kind : kinds) {
+            bits_ |= bit(kind);
+        }
+    }
+
+    constexpr bool contains(Token::Kind kind) const {
+        return (bits_ & bit(kind)) != 0;
+    }
+
+    constexpr bool operator==(TokenKindSet other) const {
+        return bits_ == other.bits_;
+    }
+
+    constexpr uint64_t bits() const { return bits_; }
+
+   private:
+    static constexpr uint64_t bit(Token::Kind kind) {
+        return uint64_t(1) << static_cast<uint8_t>(kind);
+    }
+
+    uint64_t bits_ = 0;
+};
+
+// A parse error kept in structured form. Nothing is formatted until
+// to_string() or operator<< is called, so recovering from many bad
+// statements costs no string building.
+struct Diagnostic {
+    enum class Kind : uint8_t {
+        UnexpectedToken,
+        // An Int or Real literal that does not fit int32_t or float, or a
+        // `$N` placeholder outside [1, max_parameters].
+        ValueOutOfRange,
+    };
+
+    Kind kind_;
+    TokenKindSet expected_;
+    Token::Kind got_;
+    std::string_view lexeme_;
+    Location location_;
+
+    std::string to_string() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const Diagnostic& diagnostic);
+
+}  // namespace rdb::parser
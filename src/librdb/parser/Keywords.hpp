@@ -0,0 +1,143 @@
+#pragma once
+
+#include <librdb/parser/Token.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rdb::parser {
+
+struct Keyword {
+    std::string_view text;
+    Token::Kind kind;
+};
+
+inline constexpr std::array keywords = {
+    Keyword{"SELECT", Token::Kind::KwSelect},
+    Keyword{"FROM", Token::Kind::KwFrom},
+    Keyword{"DROP", Token::Kind::KwDrop},
+    Keyword{"TABLE", Token::Kind::KwTable},
+    Keyword{"INSERT", Token::Kind::KwInsert},
+    Keyword{"INTO", Token::Kind::KwInto},
+    Keyword{"VALUES", Token::Kind::KwValues},
+    Keyword{"DELETE", Token::Kind::KwDelete},
+    Keyword{"WHERE", Token::Kind::KwWhere},
+    Keyword{"CREATE", Token::Kind::KwCreate},
+    Keyword{"INT", Token::Kind::KwInt},
+    Keyword{"REAL", Token::Kind::KwReal},
+    Keyword{"TEXT", Token::Kind::KwText},
+    Keyword{"INDEX", Token::Kind::KwIndex},
+    Keyword{"ON", Token::Kind::KwOn},
+    Keyword{"USING", Token::Kind::KwUsing},
+    Keyword{"HASH", Token::Kind::KwHash},
+    Keyword{"BTREE", Token::Kind::KwBtree},
+};
+
+namespace detail {
+
+inline constexpr size_t keyword_slots = 64;
+inline constexpr int8_t no_keyword = -1;
+
+constexpr char to_upper(char c) {
+    return ((c >= 'a') && (c <= 'z')) ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// Perfect over `keywords` (checked below). Letters are case-folded so the
+// case-sensitive and case-insensitive lookups share one table.
+constexpr size_t keyword_hash(std::string_view text) {
+    const size_t last_weight = 23;
+    return (text.size() + static_cast<unsigned char>(to_upper(text.front())) +
+            static_cast<unsigned char>(to_upper(text.back())) * last_weight) %
+        keyword_slots;
+}
+
+constexpr std::array<int8_t, keyword_slots> make_keyword_slots() {
+    std::array<int8_t, keyword_slots> slots{};
+    for (auto& slot : slots) {
+        slot = no_keyword;
+    }
+    for (size_t i = 0; i < keywords.size(); ++i) {
+        slots[keyword_hash(keywords[i].text)] = static_cast<int8_t>(i);
+    }
+    return slots;
+}
+
+inline constexpr std::array<int8_t, keyword_slots> keyword_table =
+    make_keyword_slots();
+
+constexpr bool keyword_table_is_perfect() {
+    for (size_t i = 0; i < keywords.size(); ++i) {
+        if (keyword_table[keyword_hash(keywords[i].text)] !=
+            static_cast<int8_t>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(
+    keyword_table_is_perfect(),
+    "keyword_hash collides, pick another last_weight");
+
+constexpr size_t min_keyword_size() {
+    size_t size = keywords[0].text.size();
+    for (const auto& keyword : keywords) {
+        size = keyword.text.size() < size ? keyword.text.size() : size;
+    }
+    return size;
+}
+
+constexpr size_t max_keyword_size() {
+    size_t size = 0;
+    for (const auto& keyword : keywords) {
+        size = keyword.text.size() > size ? keyword.text.size() : size;
+    }
+    return size;
+}
+
+constexpr const Keyword* find_keyword_slot(std::string_view text) {
+    if ((text.size() < min_keyword_size()) ||
+        (text.size() > max_keyword_size())) {
+        return nullptr;
+    }
+    const int8_t index = keyword_table[keyword_hash(text)];
+    if (index == no_keyword) {
+        return nullptr;
+    }
+    const Keyword& keyword = keywords[static_cast<size_t>(index)];
+    return keyword.text.size() == text.size() ? &keyword : nullptr;
+}
+
+}  // namespace detail
+
+// Kind of the keyword spelled exactly as `text`, or Token::Kind::Id.
+constexpr Token::Kind keyword_kind(std::string_view text) {
+    const Keyword* keyword = detail::find_keyword_slot(text);
+    if ((keyword == nullptr) || (keyword->text != text)) {
+        return Token::Kind::Id;
+    }
+    return keyword->kind;
+}
+
+// Same as keyword_kind, but "select" and "Select" match KwSelect too.
+constexpr Token::Kind keyword_kind_ci(std::string_view text) {
+    const Keyword* keyword = detail::find_keyword_slot(text);
+    if (keyword == nullptr) {
+        return Token::Kind::Id;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (detail::to_upper(text[i]) != keyword->text[i]) {
+            return Token::Kind::Id;
+        }
+    }
+    return keyword->kind;
+}
+
+static_assert(keyword_kind("SELECT") == Token::Kind::KwSelect);
+static_assert(keyword_kind("select") == Token::Kind::Id);
+static_assert(keyword_kind_ci("sElEcT") == Token::Kind::KwSelect);
+static_assert(keyword_kind("SELECTS") == Token::Kind::Id);
+
+}  // namespace rdb::parser
@@ -1,12 +1,13 @@
 #include <librdb/parser/Lexer.hpp>
 
+#include <librdb/parser/CharClass.hpp>
+#include <librdb/parser/Keywords.hpp>
+#include <librdb/parser/Scanner.hpp>
 #include <librdb/parser/Token.hpp>
 
 #include <cassert>
-#include <cctype>
 #include <optional>
 #include <string_view>
-#include <unordered_map>
 
 namespace rdb::parser {
 
@@ -20,129 +21,99 @@ Token Lexer::get() {
     skip_spaces();
 
     if (eof()) {
-        return Token(Token::Kind::Eof, "<EOF>", location_);
-    }
-
-    const auto next_char = peek_char();
-
-    static const std::unordered_map<char, Token::Kind> trivial_token_to_kind = {
-        {';', Token::Kind::Semicolon},
-        {',', Token::Kind::Comma},
-        {'(', Token::Kind::LParen},
-        {')', Token::Kind::RParen},
-    };
-
-    const auto it = trivial_token_to_kind.find(next_char);
-    if (it != trivial_token_to_kind.end()) {
-        const Location begin(location_);
-        get_char();
-        return make_token(it->second, begin);
-    }
-
-    if (isalpha(next_char) != 0) {
-        return get_id_or_kw();
-    }
-
-    if (isdigit(next_char) != 0) {
-        return get_number();
-    }
-
-    switch (next_char) {
-        case '-':
-        case '+':
+        return Token(
+            Token::Kind::Eof, "<EOF>", Location(offset_, line_index_.get()));
+    }
+
+    switch (char_class(peek_char())) {
+        case CharClass::Semicolon:
+            return get_trivial(Token::Kind::Semicolon);
+        case CharClass::Comma:
+            return get_trivial(Token::Kind::Comma);
+        case CharClass::LParen:
+            return get_trivial(Token::Kind::LParen);
+        case CharClass::RParen:
+            return get_trivial(Token::Kind::RParen);
+        case CharClass::Alpha:
+            return get_id_or_kw();
+        case CharClass::Digit:
+        case CharClass::Sign:
             return get_number();
-        case '"':
+        case CharClass::Quote:
             return get_string();
-        case '<':
-        case '>':
-        case '=':
-        case '!':
+        case CharClass::Param:
+            return get_parameter();
+        case CharClass::Operation:
             return get_operation();
-        default:
+        case CharClass::Space:
+        case CharClass::Other:
             break;
     }
 
-    const Location begin(location_);
-    get_char();
-    return make_token(Token::Kind::Unknown, begin);
+    return get_trivial(Token::Kind::Unknown);
 }
 
-Token Lexer::peek() {
-    if (next_token_) {
-        return *next_token_;
+const Token& Lexer::peek() {
+    if (!next_token_) {
+        next_token_ = get();
     }
-    next_token_ = get();
     return *next_token_;
 }
 
+TokenBuffer Lexer::tokenize_all() {
+    TokenBuffer tokens(input_, line_index_, source_);
+    // Scripts average a little over four bytes per token.
+    const size_t bytes_per_token = 4;
+    tokens.reserve((input_.size() - offset_) / bytes_per_token + 1);
+    while (true) {
+        const Token token = get();
+        tokens.push_back(token);
+        if (token.type() == Token::Kind::Eof) {
+            return tokens;
+        }
+    }
+}
+
 bool Lexer::eof() const {
-    return location_.offset_ == input_.size();
+    return offset_ == input_.size();
 }
 
 char Lexer::peek_char() const {
     assert(!eof());
-    return input_[location_.offset_];
+    return input_[offset_];
 }
 
 char Lexer::get_char() {
     assert(!eof());
-    if (input_[location_.offset_] == '\n') {
-        location_.cols_ = 1;
-        ++location_.rows_;
-    } else {
-        ++location_.cols_;
-    }
-    return input_[location_.offset_++];
+    return input_[offset_++];
 }
 
 void Lexer::skip_spaces() {
-    while ((!eof()) && (isspace(peek_char()) != 0)) {
-        get_char();
-    }
+    offset_ = scan_spaces(input_, offset_);
 }
 
 Token Lexer::get_id_or_kw() {
-    const Location begin(location_);
+    const size_t begin = offset_;
 
-    while ((!eof()) && (isalnum(peek_char()) != 0)) {
-        get_char();
-    }
+    get_char();
+    offset_ = scan_alnum(input_, offset_);
 
-    const Location end(location_);
-    const std::string_view text(
-        input_.substr(begin.offset_, end.offset_ - begin.offset_));
-
-    static const std::unordered_map<std::string_view, Token::Kind>
-        text_to_kind = {
-            {"SELECT", Token::Kind::KwSelect},
-            {"FROM", Token::Kind::KwFrom},
-            {"DROP", Token::Kind::KwDrop},
-            {"TABLE", Token::Kind::KwTable},
-            {"INSERT", Token::Kind::KwInsert},
-            {"INTO", Token::Kind::KwInto},
-            {"VALUES", Token::Kind::KwValues},
-            {"DELETE", Token::Kind::KwDelete},
-            {"WHERE", Token::Kind::KwWhere},
-            {"CREATE", Token::Kind::KwCreate},
-            {"INT", Token::Kind::KwInt},
-            {"REAL", Token::Kind::KwReal},
-            {"TEXT", Token::Kind::KwText},
-        };
-
-    auto it = text_to_kind.find(text);
-
-    if (it != text_to_kind.end()) {
-        return Token(it->second, text, begin);
-    }
-    return Token(Token::Kind::Id, text, begin);
+    return make_token(
+        keyword_kind(input_.substr(begin, offset_ - begin)), begin);
+}
+
+Token Lexer::get_trivial(Token::Kind kind) {
+    const size_t begin = offset_;
+    get_char();
+    return make_token(kind, begin);
 }
 
 Token Lexer::get_number() {
-    const Location begin(location_);
+    const size_t begin = offset_;
 
     if ((peek_char() == '-') || (peek_char() == '+')) {
         get_char();
-        if ((eof()) || (isdigit(peek_char()) == 0)) {
+        if ((eof()) || (!is_digit(peek_char()))) {
             return make_token(Token::Kind::Unknown, begin);
         }
     }
@@ -150,14 +121,14 @@ Token Lexer::get_number() {
     if (peek_char() == '0') {
         get_char();
     } else {
-        while ((!eof()) && (isdigit(peek_char()) != 0)) {
+        while ((!eof()) && (is_digit(peek_char()))) {
             get_char();
         }
     }
 
-    if (peek_char() == '.') {
+    if ((!eof()) && (peek_char() == '.')) {
         get_char();
-        while ((!eof()) && (isdigit(peek_char()) != 0)) {
+        while ((!eof()) && (is_digit(peek_char()))) {
             get_char();
         }
         return make_token(Token::Kind::Real, begin);
@@ -167,15 +138,12 @@ Token Lexer::get_number() {
 }
 
 Token Lexer::get_string() {
-    const Location begin(location_);
+    const size_t begin = offset_;
 
     get_char();
+    offset_ = scan_string_body(input_, offset_);
 
-    while ((!eof()) && (peek_char() != '"') && (peek_char() != '\n')) {
-        get_char();
-    }
-
-    if (peek_char() == '"') {
+    if ((!eof()) && (peek_char() == '"')) {
         get_char();
         return make_token(Token::Kind::Text, begin);
     }
@@ -183,8 +151,24 @@ Token Lexer::get_string() {
     return make_token(Token::Kind::Unknown, begin);
 }
 
+// `?` or `$` followed by digits. The parser checks the number's range.
+Token Lexer::get_parameter() {
+    const size_t begin = offset_;
+
+    if (get_char() == '?') {
+        return make_token(Token::Kind::Param, begin);
+    }
+    if ((eof()) || (!is_digit(peek_char()))) {
+        return make_token(Token::Kind::Unknown, begin);
+    }
+    while ((!eof()) && (is_digit(peek_char()))) {
+        get_char();
+    }
+    return make_token(Token::Kind::Param, begin);
+}
+
 Token Lexer::get_operation() {
-    const Location begin(location_);
+    const size_t begin = offset_;
 
     char cur_char = get_char();
 
@@ -192,7 +176,7 @@ Token Lexer::get_operation() {
         return make_token(Token::Kind::Eq, begin);
     }
 
-    if (peek_char() == '=') {
+    if ((!eof()) && (peek_char() == '=')) {
         get_char();
         switch (cur_char) {
             case '<':
@@ -215,12 +199,12 @@ Token Lexer::get_operation() {
         default:
             assert(false && "cur_char != < | > | !");
     }
+    return make_token(Token::Kind::Unknown, begin);
 }
 
-Token Lexer::make_token(Token::Kind kind, const Location& begin) const {
-    const auto length = location_.offset_ - begin.offset_;
-    const auto text = input_.substr(begin.offset_, length);
-    return Token(kind, text, begin);
+Token Lexer::make_token(Token::Kind kind, size_t begin) const {
+    const auto text = input_.substr(begin, offset_ - begin);
+    return Token(kind, text, Location(begin, line_index_.get()));
 }
 
 }  // namespace rdb::parser
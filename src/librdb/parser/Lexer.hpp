@@ -1,20 +1,48 @@
 #pragma once
 
 #include <librdb/parser/Location.hpp>
+#include <librdb/parser/ScriptSource.hpp>
 #include <librdb/parser/Token.hpp>
+#include <librdb/parser/TokenBuffer.hpp>
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <string_view>
+#include <utility>
 
 namespace rdb::parser {
 
 class Lexer {
    public:
     explicit Lexer(std::string_view input)
-        : input_(input), location_(0, 1, 1) {}
+        : input_(input),
+          offset_(0),
+          line_index_(std::make_shared<const LineIndex>(input)) {}
+
+    // Lexes a mapped file and keeps it alive in every TokenBuffer and
+    // Script produced from it.
+    explicit Lexer(std::shared_ptr<const ScriptSource> source)
+        : Lexer(source->text()) {
+        source_ = std::move(source);
+    }
+
+    // Lexes input[begin, end) only. Offsets and locations stay relative to
+    // the whole input, whose `line_index` is shared with other lexers.
+    Lexer(
+        std::string_view input,
+        size_t begin,
+        size_t end,
+        std::shared_ptr<const LineIndex> line_index)
+        : input_(input.substr(0, end)),
+          offset_(begin),
+          line_index_(std::move(line_index)) {}
 
     Token get();
-    Token peek();
+    const Token& peek();
+
+    // Lexes the rest of the input, up to and including Eof.
+    TokenBuffer tokenize_all();
 
    private:
     bool eof() const;
@@ -23,15 +51,19 @@ class Lexer {
 
     void skip_spaces();
 
+    Token get_trivial(Token::Kind kind);
     Token get_id_or_kw();
     Token get_number();
     Token get_string();
+    Token get_parameter();
     Token get_operation();
 
-    Token make_token(Token::Kind kind, const Location& begin) const;
+    Token make_token(Token::Kind kind, size_t begin) const;
 
     std::string_view input_;
-    Location location_;
+    size_t offset_;
+    std::shared_ptr<const LineIndex> line_index_;
+    std::shared_ptr<const ScriptSource> source_;
     std::optional<Token> next_token_;
 };
 
@@ -0,0 +1,39 @@
+#include <librdb/parser/Location.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace rdb::parser {
+
+size_t LineIndex::row(size_t offset) const {
+    return first_row_ + line(offset) - 1;
+}
+
+size_t LineIndex::col(size_t offset) const {
+    const size_t line_number = line(offset);
+    const size_t col = offset - line_starts()[line_number - 1] + 1;
+    return line_number == 1 ? first_col_ + col - 1 : col;
+}
+
+size_t LineIndex::line(size_t offset) const {
+    const auto& starts = line_starts();
+    return static_cast<size_t>(
+        std::upper_bound(starts.begin(), starts.end(), offset) -
+        starts.begin());
+}
+
+const std::vector<size_t>& LineIndex::line_starts() const {
+    std::call_once(built_, [this] {
+        line_starts_.push_back(0);
+        for (auto pos = input_.find('\n'); pos != std::string_view::npos;
+             pos = input_.find('\n', pos + 1)) {
+            line_starts_.push_back(pos + 1);
+        }
+    });
+    return line_starts_;
+}
+
+}  // namespace rdb::parser
@@ -1,15 +1,49 @@
 #pragma once
 
 #include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <vector>
 
 namespace rdb::parser {
 
+// Maps byte offsets of an input to 1-based rows and columns. The table of
+// line starts is built on the first query, so inputs that never report a
+// location never pay for it.
+class LineIndex {
+   public:
+    // `first_row` and `first_col` are the position of input[0] in a larger
+    // stream, e.g. a batch cut out of piped input.
+    explicit LineIndex(
+        std::string_view input,
+        size_t first_row = 1,
+        size_t first_col = 1)
+        : input_(input), first_row_(first_row), first_col_(first_col) {}
+
+    size_t row(size_t offset) const;
+    size_t col(size_t offset) const;
+
+   private:
+    const std::vector<size_t>& line_starts() const;
+    // 1-based line of `offset` within input_.
+    size_t line(size_t offset) const;
+
+    std::string_view input_;
+    size_t first_row_;
+    size_t first_col_;
+    mutable std::once_flag built_;
+    mutable std::vector<size_t> line_starts_;
+};
+
 struct Location {
-    Location(size_t offset, size_t rows, size_t cols)
-        : offset_(offset), rows_(rows), cols_(cols) {}
+    Location(size_t offset, const LineIndex* line_index)
+        : offset_(offset), line_index_(line_index) {}
+
+    size_t rows() const { return line_index_->row(offset_); }
+    size_t cols() const { return line_index_->col(offset_); }
+
     size_t offset_;
-    size_t rows_;
-    size_t cols_;
+    const LineIndex* line_index_;
 };
 
 }  // namespace rdb::parser
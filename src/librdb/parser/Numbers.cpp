@@ -0,0 +1,91 @@
+#include <librdb/parser/Numbers.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define RDB_NUMBERS_SWAR 1
+#endif
+
+namespace rdb::parser {
+
+namespace {
+
+// No int32_t needs more digits; the lexer never emits leading zeros.
+const size_t max_int_digits = 10;
+
+#ifdef RDB_NUMBERS_SWAR
+
+const size_t swar_width = 8;
+
+// Value of eight ASCII digits loaded into one little-endian word: adjacent
+// digits, then pairs, then quads are combined in three multiplies instead
+// of eight dependent ones.
+uint32_t parse_eight_digits(const char* digits) {
+    uint64_t word = 0;
+    std::memcpy(&word, digits, sizeof(word));
+    word -= 0x3030303030303030;
+    word = (word * 10) + (word >> 8);
+    const uint64_t mask = 0x000000FF000000FF;
+    const uint64_t mul_hundreds = 100 + (uint64_t(1000000) << 32);
+    const uint64_t mul_units = 1 + (uint64_t(10000) << 32);
+    word = (((word & mask) * mul_hundreds) +
+            (((word >> 16) & mask) * mul_units)) >>
+        32;
+    return static_cast<uint32_t>(word);
+}
+
+#endif  // RDB_NUMBERS_SWAR
+
+}  // namespace
+
+std::optional<int32_t> parse_int(std::string_view lexeme) {
+    bool negative = false;
+    if (!lexeme.empty() && ((lexeme[0] == '-') || (lexeme[0] == '+'))) {
+        negative = (lexeme[0] == '-');
+        lexeme.remove_prefix(1);
+    }
+    if (lexeme.size() > max_int_digits) {
+        return std::nullopt;
+    }
+
+    uint64_t magnitude = 0;
+    size_t i = 0;
+#ifdef RDB_NUMBERS_SWAR
+    if (lexeme.size() >= swar_width) {
+        magnitude = parse_eight_digits(lexeme.data());
+        i = swar_width;
+    }
+#endif
+    for (; i < lexeme.size(); ++i) {
+        magnitude = magnitude * 10 + static_cast<uint64_t>(lexeme[i] - '0');
+    }
+
+    const uint64_t limit = negative ? uint64_t(INT32_MAX) + 1 : INT32_MAX;
+    if (magnitude > limit) {
+        return std::nullopt;
+    }
+    return negative ? static_cast<int32_t>(-static_cast<int64_t>(magnitude))
+                    : static_cast<int32_t>(magnitude);
+}
+
+std::optional<float> parse_real(std::string_view lexeme) {
+    // std::from_chars takes '-' but not '+'.
+    if (!lexeme.empty() && (lexeme[0] == '+')) {
+        lexeme.remove_prefix(1);
+    }
+    float value = 0;
+    const auto [end, error] =
+        std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), value);
+    if ((error != std::errc()) || (end != lexeme.data() + lexeme.size())) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace rdb::parser {
+
+// Convert Int and Real lexemes as the lexer produces them: an optional
+// sign, digits and, for reals, a '.' with optional fraction digits. Only
+// the lexeme itself is read, and the conversion does not depend on the
+// locale. std::nullopt means the value does not fit the type.
+
+std::optional<int32_t> parse_int(std::string_view lexeme);
+
+std::optional<float> parse_real(std::string_view lexeme);
+
+}  // namespace rdb::parser
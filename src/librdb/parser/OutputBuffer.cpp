@@ -0,0 +1,39 @@
+#include <librdb/parser/OutputBuffer.hpp>
+
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+namespace rdb::parser {
+
+namespace {
+
+// "-2147483648".
+const size_t max_int_chars = 11;
+// FLT_MAX has 39 integer digits; add a sign, a point and six decimals.
+const size_t max_float_chars = 47;
+const int float_precision = 6;
+
+}  // namespace
+
+void OutputBuffer::append(int32_t number) {
+    char chars[max_int_chars];
+    const auto result = std::to_chars(chars, chars + max_int_chars, number);
+    assert(result.ec == std::errc());
+    text_.append(chars, result.ptr);
+}
+
+void OutputBuffer::append(float number) {
+    char chars[max_float_chars];
+    const auto result = std::to_chars(
+        chars,
+        chars + max_float_chars,
+        number,
+        std::chars_format::fixed,
+        float_precision);
+    assert(result.ec == std::errc());
+    text_.append(chars, result.ptr);
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace rdb::parser {
+
+// A growable character buffer that statements print into. clear() keeps
+// the capacity, so a buffer reused for many statements stops allocating
+// once it has grown to fit the longest.
+class OutputBuffer {
+   public:
+    void append(std::string_view text) { text_.append(text); }
+    void append(char c) { text_.push_back(c); }
+    // Decimal, like std::to_string(int).
+    void append(int32_t number);
+    // Fixed-point with six decimals, like std::to_string(float).
+    void append(float number);
+
+    std::string_view view() const { return text_; }
+    size_t size() const { return text_.size(); }
+    bool empty() const { return text_.empty(); }
+    void clear() { text_.clear(); }
+
+   private:
+    std::string text_;
+};
+
+}  // namespace rdb::parser
@@ -0,0 +1,186 @@
+#include <librdb/parser/ParallelParser.hpp>
+
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/Numbers.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/Scanner.hpp>
+#include <librdb/parser/Statements.hpp>
+#include <librdb/parser/Token.hpp>
+#include <librdb/parser/TokenBuffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rdb::parser {
+
+namespace {
+
+// How the placeholders among a chunk's tokens move the parameter count.
+// Only a guess at what the parser will see: after a syntax error it skips
+// the rest of the statement, placeholders included.
+struct Placeholders {
+    // The count after the chunk had it been `count` before it. Each `?`
+    // takes the index after the largest one so far, so the count rises by
+    // one per `?` and to N at `$N`.
+    uint32_t after(uint32_t count) const {
+        return std::min(
+            std::max(count + anonymous_, count_from_zero_), max_parameters);
+    }
+
+    uint32_t anonymous_ = 0;
+    uint32_t count_from_zero_ = 0;
+};
+
+Placeholders find_placeholders(const TokenBuffer& tokens) {
+    Placeholders placeholders;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens.kind(i) != Token::Kind::Param) {
+            continue;
+        }
+        const std::string_view lexeme = tokens.lexeme(i);
+        if (lexeme == "?") {
+            ++placeholders.anonymous_;
+            ++placeholders.count_from_zero_;
+        } else if (const auto number = parse_int(lexeme.substr(1))) {
+            placeholders.count_from_zero_ = std::max(
+                placeholders.count_from_zero_,
+                static_cast<uint32_t>(std::max(*number, 0)));
+        }
+    }
+    return placeholders;
+}
+
+// Calls body(i) for every i in [0, count) on up to `n_threads` threads.
+template <typename Body>
+void for_each_chunk(size_t count, size_t n_threads, const Body& body) {
+    std::atomic<size_t> next = 0;
+    const auto run = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(n_threads, count); ++i) {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+std::vector<size_t> split_at_statements(std::string_view input, size_t chunks) {
+    std::vector<size_t> boundaries = {0};
+    for (size_t i = 1; i < chunks; ++i) {
+        const size_t target = input.size() / chunks * i;
+        size_t offset = boundaries.back();
+        while (offset < target) {
+            offset = find_statement_end(input, offset);
+        }
+        if (offset >= input.size()) {
+            break;
+        }
+        if (offset > boundaries.back()) {
+            boundaries.push_back(offset);
+        }
+    }
+    boundaries.push_back(input.size());
+    return boundaries;
+}
+
+Parser::Result parse_sql_script_parallel(
+    std::string_view input,
+    size_t n_threads,
+    size_t min_chunk_size) {
+    if (n_threads == 0) {
+        n_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    // A few chunks per thread even out statements of different cost.
+    const size_t chunks_per_thread = 4;
+    const size_t chunks = std::clamp(
+        input.size() / std::max<size_t>(min_chunk_size, 1),
+        size_t(1),
+        n_threads * chunks_per_thread);
+
+    const auto boundaries = split_at_statements(input, chunks);
+    const size_t n_chunks = boundaries.size() - 1;
+    const auto line_index = std::make_shared<const LineIndex>(input);
+
+    const auto lex = [&](size_t i) {
+        Lexer lexer(input, boundaries[i], boundaries[i + 1], line_index);
+        return lexer.tokenize_all();
+    };
+
+    // Every chunk but the first starts with the parameter count of those
+    // before it. The counts are guessed from the tokens, so that all
+    // chunks can be parsed at once, and checked below.
+    std::vector<std::optional<TokenBuffer>> tokens(n_chunks);
+    std::vector<Placeholders> placeholders(n_chunks);
+    for_each_chunk(n_chunks, n_threads, [&](size_t i) {
+        tokens[i].emplace(lex(i));
+        placeholders[i] = find_placeholders(*tokens[i]);
+    });
+    std::vector<uint32_t> first_parameters(n_chunks, 0);
+    for (size_t i = 1; i < n_chunks; ++i) {
+        first_parameters[i] =
+            placeholders[i - 1].after(first_parameters[i - 1]);
+    }
+
+    std::vector<Parser::Result> results(n_chunks);
+    for_each_chunk(n_chunks, n_threads, [&](size_t i) {
+        Parser parser(std::move(*tokens[i]), first_parameters[i]);
+        tokens[i].reset();
+        results[i] = parser.parse_sql_script();
+    });
+
+    // A syntax error before a placeholder makes the guess too high; the
+    // chunks after it are parsed again with the count the parser got.
+    uint32_t parameter_count = 0;
+    for (size_t i = 0; i < n_chunks; ++i) {
+        if (first_parameters[i] != parameter_count) {
+            Parser parser(lex(i), parameter_count);
+            results[i] = parser.parse_sql_script();
+        }
+        parameter_count =
+            static_cast<uint32_t>(results[i].script.parameter_count_);
+    }
+
+    Parser::Result merged;
+    merged.line_index_ = line_index;
+    merged.script.parameter_count_ = parameter_count;
+    for (auto& result : results) {
+        merged.script.arena_.splice(std::move(result.script.arena_));
+        merged.script.statements_.insert(
+            merged.script.statements_.end(),
+            result.script.statements_.begin(),
+            result.script.statements_.end());
+        merged.errors_.insert(
+            merged.errors_.end(),
+            result.errors_.begin(),
+            result.errors_.end());
+    }
+    return merged;
+}
+
+Parser::Result parse_sql_script_parallel(
+    std::shared_ptr<const ScriptSource> source,
+    size_t n_threads,
+    size_t min_chunk_size) {
+    auto result =
+        parse_sql_script_parallel(source->text(), n_threads, min_chunk_size);
+    result.script.source_ = std::move(source);
+    return result;
+}
+
+}  // namespace rdb::parser
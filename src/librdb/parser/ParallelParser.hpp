@@ -0,0 +1,36 @@
+#pragma once
+
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace rdb::parser {
+
+inline constexpr size_t default_min_chunk_size = size_t(1) << 18;
+
+// Offsets [0, b1, ..., input.size()] cutting `input` into at most `chunks`
+// ranges of similar size. Every cut is right after a top-level ';', where
+// the parser is always back at the start of a statement.
+std::vector<size_t> split_at_statements(std::string_view input, size_t chunks);
+
+// Parses the chunks from split_at_statements on `n_threads` threads (0 for
+// one per core) and merges statements and errors back in input order. The
+// result is the same as Parser(Lexer(input)).parse_sql_script(), including
+// error locations and the numbering of `?` placeholders across chunks.
+// Inputs are not split below `min_chunk_size` bytes.
+Parser::Result parse_sql_script_parallel(
+    std::string_view input,
+    size_t n_threads = 0,
+    size_t min_chunk_size = default_min_chunk_size);
+
+// Same for a mapped file, which the resulting Script keeps alive.
+Parser::Result parse_sql_script_parallel(
+    std::shared_ptr<const ScriptSource> source,
+    size_t n_threads = 0,
+    size_t min_chunk_size = default_min_chunk_size);
+
+}  // namespace rdb::parser
@@ -1,66 +1,105 @@
 #include <librdb/parser/Parser.hpp>
 
-#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Diagnostic.hpp>
+#include <librdb/parser/Numbers.hpp>
 #include <librdb/parser/Statements.hpp>
+#include <librdb/parser/Token.hpp>
 
-#include <cassert>
-#include <charconv>
-#include <memory>
-#include <sstream>
-#include <stdexcept>
-#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string_view>
-#include <vector>
+#include <utility>
+#include <variant>
 
 namespace rdb::parser {
 
-namespace {
-class SyntaxError : public std::runtime_error {
-   public:
-    using std::runtime_error::runtime_error;
-};
-}  // namespace
-
-static std::string make_error_msg(std::string_view expected, Token got) {
-    return "Expected " + std::string(expected) + ", got " +
-           std::string(kind_to_str(got.type())) + " '" +
-           std::string(got.lexeme()) + "' " +
-           std::to_string(got.location().rows_) + ":" +
-           std::to_string(got.location().cols_);
-}
-
 Parser::Result Parser::parse_sql_script() {
     Parser::Result result;
-    while (true) {
-        Token next_token = lexer_.peek();
-        if (next_token.type() == Token::Kind::Eof) {
-            break;
-        }
-        try {
-            result.script.statements_.push_back(parse_sql_statement());
-        } catch (const SyntaxError& e) {
-            result.errors_.emplace_back(e.what());
+    // Statements are stored by value, so growing the vector is not free.
+    // Every statement but the last ends with a ';'.
+    statements_.reserve(tokens_.count(Token::Kind::Semicolon) + 1);
+    while (peek_kind() != Token::Kind::Eof) {
+        if (!parse_sql_statement()) {
             panic();
         }
     }
 
+    result.script.statements_ = std::move(statements_);
+
+    result.script.source_ = tokens_.source();
+    result.script.parameter_count_ = parameter_count_;
+    result.script.arena_ = std::move(arena_);
+    result.errors_ = std::move(errors_);
+    result.line_index_ = tokens_.line_index();
     return result;
 }
 
 void Parser::panic() {
     while (true) {
-        const Token preview = lexer_.get();
-        if ((preview.type() == Token::Kind::Eof) ||
-            (preview.type() == Token::Kind::Semicolon)) {
+        const Token::Kind kind = peek_kind();
+        if (kind == Token::Kind::Eof) {
+            break;
+        }
+        ++cursor_;
+        if (kind == Token::Kind::Semicolon) {
             break;
         }
     }
 }
 
-StatementPtr Parser::parse_sql_statement() {
-    const Token token = lexer_.peek();
-    switch (token.type()) {
+void Parser::report(TokenKindSet expected) {
+    const Token token = peek();
+    errors_.push_back(
+        {Diagnostic::Kind::UnexpectedToken,
+         expected,
+         token.type(),
+         token.lexeme(),
+         token.location()});
+}
+
+void Parser::report_out_of_range() {
+    const Token token = peek();
+    errors_.push_back(
+        {Diagnostic::Kind::ValueOutOfRange,
+         {},
+         token.type(),
+         token.lexeme(),
+         token.location()});
+}
+
+bool Parser::accept(Token::Kind kind) {
+    if (peek_kind() != kind) {
+        return false;
+    }
+    ++cursor_;
+    return true;
+}
+
+bool Parser::fetch_token(Token::Kind expected_kind) {
+    if (!accept(expected_kind)) {
+        report({expected_kind});
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string_view> Parser::fetch_lexeme(
+    Token::Kind expected_kind) {
+    const std::string_view lexeme = tokens_.lexeme(cursor_);
+    if (!fetch_token(expected_kind)) {
+        return std::nullopt;
+    }
+    return lexeme;
+}
+
+bool Parser::parse_sql_statement() {
+    switch (peek_kind()) {
         case Token::Kind::KwCreate:
+            if (tokens_.kind(cursor_ + 1) == Token::Kind::KwIndex) {
+                return parse_create_index_statement();
+            }
             return parse_create_table_statement();
         case Token::Kind::KwSelect:
             return parse_select_statement();
@@ -73,224 +112,503 @@ StatementPtr Parser::parse_sql_statement() {
         default:
             break;
     }
-    throw SyntaxError(
-        make_error_msg("CREATE, SELECT, INSERT, DELETE or DROP", token));
-}
-
-Token Parser::fetch_token(Token::Kind expected_kind) {
-    Token token = lexer_.peek();
-    if (token.type() != expected_kind) {
-        throw SyntaxError(make_error_msg(kind_to_str(expected_kind), token));
-    }
-    return lexer_.get();
+    report(
+        {Token::Kind::KwCreate,
+         Token::Kind::KwSelect,
+         Token::Kind::KwInsert,
+         Token::Kind::KwDelete,
+         Token::Kind::KwDrop});
+    return false;
 }
 
-ColumnDef Parser::parse_column_def() {
+std::optional<ColumnDef> Parser::parse_column_def() {
     ColumnDef column_def;
-    const Token column_name = fetch_token(Token::Kind::Id);
-    column_def.column_name_ = column_name.lexeme();
+    const auto column_name = fetch_lexeme(Token::Kind::Id);
+    if (!column_name) {
+        return std::nullopt;
+    }
+    column_def.column_name_ = *column_name;
 
-    const Token token = lexer_.peek();
-    switch (token.type()) {
+    switch (peek_kind()) {
         case Token::Kind::KwInt:
-            lexer_.get();
+            ++cursor_;
             column_def.type_ = ColumnDef::Type::Int;
             return column_def;
         case Token::Kind::KwReal:
-            lexer_.get();
+            ++cursor_;
             column_def.type_ = ColumnDef::Type::Real;
             return column_def;
         case Token::Kind::KwText:
-            lexer_.get();
+            ++cursor_;
             column_def.type_ = ColumnDef::Type::Text;
             return column_def;
         default:
-            throw SyntaxError(make_error_msg("INT, REAL or TEXT", token));
+            report(
+                {Token::Kind::KwInt, Token::Kind::KwReal, Token::Kind::KwText});
+            return std::nullopt;
     }
 }
 
-Value Parser::parse_value() {
-    const Token token = lexer_.peek();
-    const int base = 10;
-    switch (token.type()) {
+std::optional<Value> Parser::parse_value() {
+    const std::string_view lexeme = tokens_.lexeme(cursor_);
+    switch (peek_kind()) {
         case Token::Kind::Int: {
-            lexer_.get();
-            Value val =
-                int32_t(std::strtol(token.lexeme().data(), nullptr, base));
+            const auto number = parse_int(lexeme);
+            if (!number) {
+                report_out_of_range();
+                return std::nullopt;
+            }
+            ++cursor_;
+            Value val = *number;
             return val;
         }
         case Token::Kind::Real: {
-            lexer_.get();
-            Value val = std::strtof(token.lexeme().data(), nullptr);
+            const auto number = parse_real(lexeme);
+            if (!number) {
+                report_out_of_range();
+                return std::nullopt;
+            }
+            ++cursor_;
+            Value val = *number;
             return val;
         }
         case Token::Kind::Text: {
-            lexer_.get();
-            Value val = token.lexeme();
+            ++cursor_;
+            Value val = lexeme;
+            return val;
+        }
+        case Token::Kind::Param: {
+            const auto parameter = parse_parameter(lexeme);
+            if (!parameter) {
+                report_out_of_range();
+                return std::nullopt;
+            }
+            ++cursor_;
+            Value val = *parameter;
             return val;
         }
         default:
-            throw SyntaxError(make_error_msg("value", token));
+            report(
+                {Token::Kind::Int,
+                 Token::Kind::Real,
+                 Token::Kind::Text,
+                 Token::Kind::Param});
+            return std::nullopt;
     }
 }
 
-Expression::Operand Parser::parse_operand() {
-    const Token token = lexer_.peek();
-    if (token.type() == Token::Kind::Id) {
-        lexer_.get();
-        return token.lexeme();
+// `?` takes the index after the largest one so far; nullopt if `$N` is not
+// in [1, max_parameters] or `?` would go past it.
+std::optional<Parameter> Parser::parse_parameter(std::string_view lexeme) {
+    uint32_t index = parameter_count_;
+    if (lexeme != "?") {
+        const auto number = parse_int(lexeme.substr(1));
+        if (!number || (*number < 1) ||
+            (static_cast<uint32_t>(*number) > max_parameters)) {
+            return std::nullopt;
+        }
+        index = static_cast<uint32_t>(*number) - 1;
+    } else if (index == max_parameters) {
+        return std::nullopt;
     }
-    switch (token.type()) {
+    parameter_count_ = std::max(parameter_count_, index + 1);
+    return Parameter{index};
+}
+
+std::optional<Expression::Operand> Parser::parse_operand() {
+    switch (peek_kind()) {
+        case Token::Kind::Id:
+            return Expression::Operand(*fetch_lexeme(Token::Kind::Id));
         case Token::Kind::Int:
         case Token::Kind::Real:
         case Token::Kind::Text:
-            return parse_value();
+        case Token::Kind::Param: {
+            const auto value = parse_value();
+            if (!value) {
+                return std::nullopt;
+            }
+            return Expression::Operand(*value);
+        }
         default:
-            throw SyntaxError(make_error_msg("operand", token));
+            report(
+                {Token::Kind::Id,
+                 Token::Kind::Int,
+                 Token::Kind::Real,
+                 Token::Kind::Text,
+                 Token::Kind::Param});
+            return std::nullopt;
     }
 }
 
-Expression::Operation Parser::parse_operation() {
-    const Token token = lexer_.get();
-    switch (token.type()) {
+std::optional<Expression::Operation> Parser::parse_operation() {
+    std::optional<Expression::Operation> operation;
+    switch (peek_kind()) {
         case Token::Kind::Lte:
-            return Expression::Operation::Lte;
+            operation = Expression::Operation::Lte;
+            break;
         case Token::Kind::Rte:
-            return Expression::Operation::Rte;
+            operation = Expression::Operation::Rte;
+            break;
         case Token::Kind::Neq:
-            return Expression::Operation::Neq;
+            operation = Expression::Operation::Neq;
+            break;
         case Token::Kind::Lt:
-            return Expression::Operation::Lt;
+            operation = Expression::Operation::Lt;
+            break;
         case Token::Kind::Rt:
-            return Expression::Operation::Rt;
+            operation = Expression::Operation::Rt;
+            break;
         case Token::Kind::Eq:
-            return Expression::Operation::Eq;
+            operation = Expression::Operation::Eq;
+            break;
         default:
-            throw SyntaxError(make_error_msg("opration", token));
+            report(
+                {Token::Kind::Lte,
+                 Token::Kind::Rte,
+                 Token::Kind::Neq,
+                 Token::Kind::Lt,
+                 Token::Kind::Rt,
+                 Token::Kind::Eq});
+            return std::nullopt;
     }
+    ++cursor_;
+    return operation;
 }
 
-Expression Parser::parse_expression() {
+std::optional<Expression> Parser::parse_expression() {
     Expression expression;
-    expression.left_ = parse_operand();
-    expression.operation_ = parse_operation();
-    expression.right_ = parse_operand();
+    const auto left = parse_operand();
+    if (!left) {
+        return std::nullopt;
+    }
+    const auto operation = parse_operation();
+    if (!operation) {
+        return std::nullopt;
+    }
+    const auto right = parse_operand();
+    if (!right) {
+        return std::nullopt;
+    }
+    expression.left_ = *left;
+    expression.operation_ = *operation;
+    expression.right_ = *right;
     return expression;
 }
 
-CreateTableStatementPtr Parser::parse_create_table_statement() {
-    fetch_token(Token::Kind::KwCreate);
-    fetch_token(Token::Kind::KwTable);
+bool Parser::parse_create_table_statement() {
+    if (!fetch_token(Token::Kind::KwCreate)) {
+        return false;
+    }
+    if (!accept(Token::Kind::KwTable)) {
+        report({Token::Kind::KwTable, Token::Kind::KwIndex});
+        return false;
+    }
 
-    const Token table_name = fetch_token(Token::Kind::Id);
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name || !fetch_token(Token::Kind::LParen)) {
+        return false;
+    }
 
-    fetch_token(Token::Kind::LParen);
-    std::vector<ColumnDef> column_defs;
-    const ColumnDef first_column_def = parse_column_def();
-    column_defs.push_back(first_column_def);
+    column_defs_.clear();
+    do {
+        const auto column_def = parse_column_def();
+        if (!column_def) {
+            return false;
+        }
+        column_defs_.push_back(*column_def);
+    } while (accept(Token::Kind::Comma));
 
-    while (lexer_.peek().type() == Token::Kind::Comma) {
-        fetch_token(Token::Kind::Comma);
-        const ColumnDef next_column_def = parse_column_def();
-        column_defs.push_back(next_column_def);
+    if (!fetch_token(Token::Kind::RParen) ||
+        !fetch_token(Token::Kind::Semicolon)) {
+        return false;
     }
 
-    fetch_token(Token::Kind::RParen);
+    statements_.emplace_back(
+        std::in_place_type<CreateTableStatement>,
+        *table_name,
+        arena_.copy(column_defs_));
+    return true;
+}
 
-    fetch_token(Token::Kind::Semicolon);
+bool Parser::parse_select_statement() {
+    if (!fetch_token(Token::Kind::KwSelect)) {
+        return false;
+    }
 
-    return std::make_unique<const CreateTableStatement>(
-        table_name.lexeme(), column_defs);
+    column_names_.clear();
+    do {
+        const auto column_name = fetch_lexeme(Token::Kind::Id);
+        if (!column_name) {
+            return false;
+        }
+        column_names_.push_back(*column_name);
+    } while (peek_kind() != Token::Kind::KwFrom);
+
+    if (!fetch_token(Token::Kind::KwFrom)) {
+        return false;
+    }
+
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name) {
+        return false;
+    }
+
+    std::optional<Expression> expression;
+    if (accept(Token::Kind::KwWhere)) {
+        expression = parse_expression();
+        if (!expression) {
+            return false;
+        }
+    }
+
+    if (!fetch_token(Token::Kind::Semicolon)) {
+        return false;
+    }
+    statements_.emplace_back(
+        std::in_place_type<SelectStatement>,
+        arena_.copy(column_names_),
+        *table_name,
+        expression);
+    return true;
 }
 
-SelectStatementPtr Parser::parse_select_statement() {
-    fetch_token(Token::Kind::KwSelect);
-    std::vector<std::string_view> column_names;
-    const Token first_column_name = fetch_token(Token::Kind::Id);
-    column_names.push_back(first_column_name.lexeme());
+bool Parser::parse_insert_statement() {
+    if (!fetch_token(Token::Kind::KwInsert) ||
+        !fetch_token(Token::Kind::KwInto)) {
+        return false;
+    }
 
-    while (lexer_.peek().type() != Token::Kind::KwFrom) {
-        const Token next_column_name = fetch_token(Token::Kind::Id);
-        column_names.push_back(next_column_name.lexeme());
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name || !fetch_token(Token::Kind::LParen)) {
+        return false;
     }
 
-    fetch_token(Token::Kind::KwFrom);
+    column_names_.clear();
+    do {
+        const auto column_name = fetch_lexeme(Token::Kind::Id);
+        if (!column_name) {
+            return false;
+        }
+        column_names_.push_back(*column_name);
+    } while (accept(Token::Kind::Comma));
 
-    const Token table_name = fetch_token(Token::Kind::Id);
+    if (!fetch_token(Token::Kind::RParen) ||
+        !fetch_token(Token::Kind::KwValues)) {
+        return false;
+    }
+
+    values_.clear();
+    value_types_.clear();
+    value_parameters_.clear();
+    size_t row_count = 0;
+    do {
+        if (!parse_values_row()) {
+            return false;
+        }
+        ++row_count;
+    } while (accept(Token::Kind::Comma));
 
-    if (lexer_.peek().type() == Token::Kind::KwWhere) {
-        fetch_token(Token::Kind::KwWhere);
-        const Expression expression = parse_expression();
-        fetch_token(Token::Kind::Semicolon);
-        return std::make_unique<const SelectStatement>(
-            column_names, table_name.lexeme(), expression);
+    if (!fetch_token(Token::Kind::Semicolon)) {
+        return false;
     }
 
-    fetch_token(Token::Kind::Semicolon);
-    return std::make_unique<const SelectStatement>(
-        column_names, table_name.lexeme());
+    statements_.emplace_back(
+        std::in_place_type<InsertStatement>,
+        *table_name,
+        arena_.copy(column_names_),
+        copy_value_columns(row_count),
+        row_count);
+    return true;
 }
 
-InsertStatementPtr Parser::parse_insert_statement() {
-    fetch_token(Token::Kind::KwInsert);
-    fetch_token(Token::Kind::KwInto);
-    const Token table_name = fetch_token(Token::Kind::Id);
+// Parses one `(...)` row of exactly column_names_.size() values. The first
+// literal fixes the type of each column; later ones may only widen INT to
+// REAL. Parameters fit any column.
+bool Parser::parse_values_row() {
+    if (!fetch_token(Token::Kind::LParen)) {
+        return false;
+    }
+    const bool first_row = values_.empty();
+    for (size_t column = 0; column < column_names_.size(); ++column) {
+        if ((column > 0) && !fetch_token(Token::Kind::Comma)) {
+            return false;
+        }
 
-    fetch_token(Token::Kind::LParen);
-    std::vector<std::string_view> column_names;
-    const Token first_column_name = fetch_token(Token::Kind::Id);
-    column_names.push_back(first_column_name.lexeme());
+        const Token::Kind kind = peek_kind();
+        if (!first_row && value_types_[column] &&
+            (kind != Token::Kind::Param)) {
+            const bool is_text = (value_types_[column] == ColumnDef::Type::Text);
+            if (is_text && (kind != Token::Kind::Text)) {
+                report({Token::Kind::Text});
+                return false;
+            }
+            if (!is_text && (kind == Token::Kind::Text)) {
+                report({Token::Kind::Int, Token::Kind::Real});
+                return false;
+            }
+        }
 
-    while (lexer_.peek().type() == Token::Kind::Comma) {
-        fetch_token(Token::Kind::Comma);
-        const Token next_column_name = fetch_token(Token::Kind::Id);
-        column_names.push_back(next_column_name.lexeme());
+        const auto value = parse_value();
+        if (!value) {
+            return false;
+        }
+        values_.push_back(*value);
+        if (first_row) {
+            value_types_.emplace_back();
+            value_parameters_.push_back(false);
+        }
+        if (kind == Token::Kind::Param) {
+            value_parameters_[column] = true;
+            continue;
+        }
+
+        ColumnDef::Type type = ColumnDef::Type::Int;
+        if (kind == Token::Kind::Real) {
+            type = ColumnDef::Type::Real;
+        } else if (kind == Token::Kind::Text) {
+            type = ColumnDef::Type::Text;
+        }
+        if (!value_types_[column] || (type == ColumnDef::Type::Real)) {
+            value_types_[column] = type;
+        }
     }
+    return fetch_token(Token::Kind::RParen);
+}
 
-    fetch_token(Token::Kind::RParen);
+Span<const ValueColumn> Parser::copy_value_columns(size_t row_count) {
+    const size_t n_columns = value_types_.size();
+    value_columns_.clear();
+    for (size_t column = 0; column < n_columns; ++column) {
+        ValueColumn value_column{
+            value_types_[column].value_or(ColumnDef::Type::Int),
+            {},
+            {},
+            {},
+            {}};
+        if (value_parameters_[column]) {
+            column_values_.clear();
+            for (size_t row = 0; row < row_count; ++row) {
+                column_values_.push_back(values_[row * n_columns + column]);
+            }
+            value_column.values_ = arena_.copy(column_values_);
+            value_columns_.push_back(value_column);
+            continue;
+        }
+        switch (value_column.type_) {
+            case ColumnDef::Type::Int:
+                ints_.clear();
+                for (size_t row = 0; row < row_count; ++row) {
+                    ints_.push_back(
+                        std::get<int32_t>(values_[row * n_columns + column]));
+                }
+                value_column.ints_ = arena_.copy(ints_);
+                break;
+            case ColumnDef::Type::Real:
+                reals_.clear();
+                for (size_t row = 0; row < row_count; ++row) {
+                    const Value& value = values_[row * n_columns + column];
+                    const int32_t* int_value = std::get_if<int32_t>(&value);
+                    reals_.push_back(
+                        int_value != nullptr ? static_cast<float>(*int_value)
+                                             : std::get<float>(value));
+                }
+                value_column.reals_ = arena_.copy(reals_);
+                break;
+            case ColumnDef::Type::Text:
+                texts_.clear();
+                for (size_t row = 0; row < row_count; ++row) {
+                    texts_.push_back(std::get<std::string_view>(
+                        values_[row * n_columns + column]));
+                }
+                value_column.texts_ = arena_.copy(texts_);
+                break;
+        }
+        value_columns_.push_back(value_column);
+    }
+    return arena_.copy(value_columns_);
+}
 
-    fetch_token(Token::Kind::KwValues);
-    fetch_token(Token::Kind::LParen);
-    std::vector<Value> values;
-    const Value first_value = parse_value();
-    values.push_back(first_value);
+bool Parser::parse_delete_statement() {
+    if (!fetch_token(Token::Kind::KwDelete) ||
+        !fetch_token(Token::Kind::KwFrom)) {
+        return false;
+    }
 
-    while (lexer_.peek().type() == Token::Kind::Comma) {
-        fetch_token(Token::Kind::Comma);
-        const Value next_value = parse_value();
-        values.push_back(next_value);
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name) {
+        return false;
     }
 
-    fetch_token(Token::Kind::RParen);
-    fetch_token(Token::Kind::Semicolon);
+    std::optional<Expression> expression;
+    if (accept(Token::Kind::KwWhere)) {
+        expression = parse_expression();
+        if (!expression) {
+            return false;
+        }
+    }
 
-    return std::make_unique<const InsertStatement>(
-        table_name.lexeme(), column_names, values);
+    if (!fetch_token(Token::Kind::Semicolon)) {
+        return false;
+    }
+    statements_.emplace_back(
+        std::in_place_type<DeleteStatement>, *table_name, expression);
+    return true;
 }
 
-DeleteStatementPtr Parser::parse_delete_statement() {
-    fetch_token(Token::Kind::KwDelete);
-    fetch_token(Token::Kind::KwFrom);
-    const Token table_name = fetch_token(Token::Kind::Id);
-
-    if (lexer_.peek().type() == Token::Kind::KwWhere) {
-        fetch_token(Token::Kind::KwWhere);
-        const Expression expression = parse_expression();
-        fetch_token(Token::Kind::Semicolon);
-        return std::make_unique<const DeleteStatement>(
-            table_name.lexeme(), expression);
+bool Parser::parse_drop_table_statement() {
+    if (!fetch_token(Token::Kind::KwDrop) ||
+        !fetch_token(Token::Kind::KwTable)) {
+        return false;
     }
 
-    fetch_token(Token::Kind::Semicolon);
-    return std::make_unique<const DeleteStatement>(table_name.lexeme());
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name || !fetch_token(Token::Kind::Semicolon)) {
+        return false;
+    }
+    statements_.emplace_back(
+        std::in_place_type<DropTableStatement>, *table_name);
+    return true;
 }
 
-DropTableStatementPtr Parser::parse_drop_table_statement() {
-    fetch_token(Token::Kind::KwDrop);
-    fetch_token(Token::Kind::KwTable);
-    const Token table_name = fetch_token(Token::Kind::Id);
-    fetch_token(Token::Kind::Semicolon);
-    return std::make_unique<const DropTableStatement>(table_name.lexeme());
+bool Parser::parse_create_index_statement() {
+    if (!fetch_token(Token::Kind::KwCreate) ||
+        !fetch_token(Token::Kind::KwIndex)) {
+        return false;
+    }
+
+    const auto index_name = fetch_lexeme(Token::Kind::Id);
+    if (!index_name || !fetch_token(Token::Kind::KwOn)) {
+        return false;
+    }
+    const auto table_name = fetch_lexeme(Token::Kind::Id);
+    if (!table_name || !fetch_token(Token::Kind::LParen)) {
+        return false;
+    }
+    const auto column_name = fetch_lexeme(Token::Kind::Id);
+    if (!column_name || !fetch_token(Token::Kind::RParen)) {
+        return false;
+    }
+
+    auto method = CreateIndexStatement::Method::BTree;
+    if (accept(Token::Kind::KwUsing)) {
+        if (accept(Token::Kind::KwHash)) {
+            method = CreateIndexStatement::Method::Hash;
+        } else if (!accept(Token::Kind::KwBtree)) {
+            report({Token::Kind::KwHash, Token::Kind::KwBtree});
+            return false;
+        }
+    }
+    if (!fetch_token(Token::Kind::Semicolon)) {
+        return false;
+    }
+
+    statements_.emplace_back(
+        std::in_place_type<CreateIndexStatement>,
+        *index_name,
+        *table_name,
+        *column_name,
+        method);
+    return true;
 }
 
 }  // namespace rdb::parser
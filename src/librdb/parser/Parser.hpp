@@ -1,8 +1,19 @@
 #pragma once
 
+#include <librdb/parser/AstArena.hpp>
+#include <librdb/parser/Diagnostic.hpp>
 #include <librdb/parser/Lexer.hpp>
 #include <librdb/parser/Script.hpp>
 #include <librdb/parser/Statements.hpp>
+#include <librdb/parser/TokenBuffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace rdb::parser {
 
@@ -10,35 +21,76 @@ class Parser {
    public:
     struct Result {
         Script script;
-        std::vector<std::string> errors_;
+        std::vector<Diagnostic> errors_;
+        // Resolves the locations in errors_.
+        std::shared_ptr<const LineIndex> line_index_;
     };
 
-    explicit Parser(Lexer& lexer) : lexer_(lexer) {}
+    explicit Parser(Lexer& lexer) : tokens_(lexer.tokenize_all()) {}
+    explicit Parser(TokenBuffer tokens) : tokens_(std::move(tokens)) {}
+    // Numbers `?` as if placeholders up to index `parameter_count` - 1
+    // came before `tokens`, e.g. in earlier chunks of one input.
+    Parser(TokenBuffer tokens, uint32_t parameter_count)
+        : tokens_(std::move(tokens)), parameter_count_(parameter_count) {}
 
     Result parse_sql_script();
 
    private:
+    // Parse functions report the first syntax error of a statement here
+    // and return std::nullopt or false up to parse_sql_script().
+    void report(TokenKindSet expected);
+    void report_out_of_range();
     void panic();
 
-    StatementPtr parse_sql_statement();
+    Token::Kind peek_kind() const { return tokens_.kind(cursor_); }
+    Token peek() const { return tokens_.token(cursor_); }
+    bool accept(Token::Kind kind);
+
+    bool parse_sql_statement();
+
+    bool fetch_token(Token::Kind expected_kind);
+    std::optional<std::string_view> fetch_lexeme(Token::Kind expected_kind);
 
-    Token fetch_token(Token::Kind expected_kind);
+    std::optional<ColumnDef> parse_column_def();
 
-    ColumnDef parse_column_def();
+    std::optional<Value> parse_value();
+    std::optional<Parameter> parse_parameter(std::string_view lexeme);
+    bool parse_values_row();
+    Span<const ValueColumn> copy_value_columns(size_t row_count);
 
-    Value parse_value();
+    std::optional<Expression::Operand> parse_operand();
+    std::optional<Expression::Operation> parse_operation();
+    std::optional<Expression> parse_expression();
 
-    Expression::Operand parse_operand();
-    Expression::Operation parse_operation();
-    Expression parse_expression();
+    bool parse_create_table_statement();
+    bool parse_select_statement();
+    bool parse_insert_statement();
+    bool parse_delete_statement();
+    bool parse_drop_table_statement();
+    bool parse_create_index_statement();
 
-    CreateTableStatementPtr parse_create_table_statement();
-    SelectStatementPtr parse_select_statement();
-    InsertStatementPtr parse_insert_statement();
-    DeleteStatementPtr parse_delete_statement();
-    DropTableStatementPtr parse_drop_table_statement();
+    TokenBuffer tokens_;
+    size_t cursor_ = 0;
 
-    Lexer& lexer_;
+    AstArena arena_;
+    // Each parse_*_statement() constructs its statement in place here.
+    std::vector<Statement> statements_;
+    std::vector<Diagnostic> errors_;
+    uint32_t parameter_count_ = 0;
+    // Scratch lists reused by every statement before they are copied into
+    // the arena.
+    std::vector<ColumnDef> column_defs_;
+    std::vector<std::string_view> column_names_;
+    // INSERT rows, row-major, the type of each column's literals so far
+    // and whether it holds a parameter.
+    std::vector<Value> values_;
+    std::vector<std::optional<ColumnDef::Type>> value_types_;
+    std::vector<bool> value_parameters_;
+    std::vector<ValueColumn> value_columns_;
+    std::vector<Value> column_values_;
+    std::vector<int32_t> ints_;
+    std::vector<float> reals_;
+    std::vector<std::string_view> texts_;
 };
 
 }  // namespace rdb::parser
@@ -0,0 +1,286 @@
+#include <librdb/parser/PreparedStatement.hpp>
+
+#include <librdb/parser/AstArena.hpp>
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Span.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rdb::parser {
+
+namespace {
+
+// Rebuilds statements in a new arena. Parameters are taken from
+// `parameters` if it is set, literals from `literals` in the order the
+// parser met them if that is set; everything else is kept.
+class Binder {
+   public:
+    Binder(
+        const std::vector<Value>* parameters,
+        const std::vector<Value>* literals,
+        AstArena& arena)
+        : parameters_(parameters), literals_(literals), arena_(arena) {}
+
+    // std::nullopt if an INSERT column cannot be typed.
+    std::optional<Statement> bind(const Statement& statement) {
+        using Result = std::optional<Statement>;
+        return std::visit(
+            Overloaded{
+                [&](const CreateTableStatement& create) -> Result {
+                    return CreateTableStatement(
+                        create.table_name(),
+                        arena_.copy(create.column_defs()));
+                },
+                [&](const SelectStatement& select) -> Result {
+                    return SelectStatement(
+                        arena_.copy(select.column_names()),
+                        select.table_name(),
+                        bind(select.expression()));
+                },
+                [&](const InsertStatement& insert) -> Result {
+                    return bind(insert);
+                },
+                [&](const DeleteStatement& remove) -> Result {
+                    return DeleteStatement(
+                        remove.table_name(), bind(remove.expression()));
+                },
+                [&](const DropTableStatement& drop) -> Result {
+                    return drop;
+                },
+                [&](const CreateIndexStatement& create) -> Result {
+                    return create;
+                },
+            },
+            statement);
+    }
+
+    bool done() const {
+        return (literals_ == nullptr) || (next_literal_ == literals_->size());
+    }
+
+   private:
+    Value bind(const Value& value) {
+        if (const auto* parameter = std::get_if<Parameter>(&value)) {
+            if (parameters_ == nullptr) {
+                return value;
+            }
+            const Value& bound = (*parameters_)[parameter->index_];
+            if (const auto* text = std::get_if<std::string_view>(&bound)) {
+                return quote(*text);
+            }
+            assert(!std::holds_alternative<Parameter>(bound));
+            return bound;
+        }
+        if (literals_ == nullptr) {
+            return value;
+        }
+        assert(next_literal_ < literals_->size());
+        return (*literals_)[next_literal_++];
+    }
+
+    // `text` in quotes, as the lexer would have left it.
+    std::string_view quote(std::string_view text) {
+        char* data = static_cast<char*>(arena_.allocate(text.size() + 2, 1));
+        data[0] = '"';
+        std::memcpy(data + 1, text.data(), text.size());
+        data[text.size() + 1] = '"';
+        return {data, text.size() + 2};
+    }
+
+    Expression::Operand bind(const Expression::Operand& operand) {
+        if (const auto* value = std::get_if<Value>(&operand)) {
+            return bind(*value);
+        }
+        return operand;
+    }
+
+    std::optional<Expression> bind(
+        const std::optional<Expression>& expression) {
+        if (!expression) {
+            return std::nullopt;
+        }
+        const Expression::Operand left = bind(expression->left_);
+        const Expression::Operand right = bind(expression->right_);
+        return Expression{left, expression->operation_, right};
+    }
+
+    // `count` elements built by `make(i)` straight in the arena.
+    template <typename T, typename Make>
+    Span<const T> make_array(size_t count, const Make& make) {
+        if (count == 0) {
+            return {};
+        }
+        T* data = static_cast<T*>(
+            arena_.allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i) {
+            new (data + i) T(make(i));
+        }
+        return {data, count};
+    }
+
+    // The type the parser would have given a column of these values, or
+    // std::nullopt if it mixes TEXT and numbers.
+    static std::optional<ColumnDef::Type> column_type(
+        const std::vector<Value>& cells,
+        size_t column,
+        size_t n_columns) {
+        size_t texts = 0;
+        size_t reals = 0;
+        const size_t row_count = cells.size() / n_columns;
+        for (size_t row = 0; row < row_count; ++row) {
+            const Value& value = cells[row * n_columns + column];
+            texts += std::holds_alternative<std::string_view>(value) ? 1 : 0;
+            reals += std::holds_alternative<float>(value) ? 1 : 0;
+        }
+        if (texts == row_count) {
+            return ColumnDef::Type::Text;
+        }
+        if (texts > 0) {
+            return std::nullopt;
+        }
+        return reals > 0 ? ColumnDef::Type::Real : ColumnDef::Type::Int;
+    }
+
+    // Values come row by row; each column is retyped from its new values.
+    std::optional<Statement> bind(const InsertStatement& insert) {
+        const size_t n_columns = insert.columns().size();
+        const size_t row_count = insert.row_count();
+        cells_.clear();
+        for (size_t row = 0; row < row_count; ++row) {
+            for (size_t column = 0; column < n_columns; ++column) {
+                cells_.push_back(bind(insert.value(row, column)));
+            }
+        }
+
+        bool typed = true;
+        const auto make_column = [&](size_t column) {
+            const auto value_at = [&](size_t row) -> const Value& {
+                return cells_[row * n_columns + column];
+            };
+            ValueColumn value_column{ColumnDef::Type::Int, {}, {}, {}, {}};
+            for (size_t row = 0; row < row_count; ++row) {
+                if (std::holds_alternative<Parameter>(value_at(row))) {
+                    value_column.values_ =
+                        make_array<Value>(row_count, value_at);
+                    return value_column;
+                }
+            }
+            const auto type = column_type(cells_, column, n_columns);
+            if (!type) {
+                typed = false;
+                return value_column;
+            }
+            value_column.type_ = *type;
+            switch (value_column.type_) {
+                case ColumnDef::Type::Int:
+                    value_column.ints_ =
+                        make_array<int32_t>(row_count, [&](size_t row) {
+                            return std::get<int32_t>(value_at(row));
+                        });
+                    break;
+                case ColumnDef::Type::Real:
+                    value_column.reals_ =
+                        make_array<float>(row_count, [&](size_t row) {
+                            const Value& value = value_at(row);
+                            const auto* number = std::get_if<int32_t>(&value);
+                            return number != nullptr
+                                ? static_cast<float>(*number)
+                                : std::get<float>(value);
+                        });
+                    break;
+                case ColumnDef::Type::Text:
+                    value_column.texts_ = make_array<std::string_view>(
+                        row_count, [&](size_t row) {
+                            return std::get<std::string_view>(value_at(row));
+                        });
+                    break;
+            }
+            return value_column;
+        };
+        const auto columns = make_array<ValueColumn>(n_columns, make_column);
+        if (!typed) {
+            return std::nullopt;
+        }
+
+        return InsertStatement(
+            insert.table_name(),
+            arena_.copy(insert.column_names()),
+            columns,
+            row_count);
+    }
+
+    const std::vector<Value>* parameters_;
+    const std::vector<Value>* literals_;
+    AstArena& arena_;
+    size_t next_literal_ = 0;
+    // INSERT values, row-major, after binding.
+    std::vector<Value> cells_;
+};
+
+}  // namespace
+
+std::optional<Script> PreparedStatement::bind(
+    const std::vector<Value>& parameters) const {
+    if (parameters.size() != parameter_count()) {
+        return std::nullopt;
+    }
+    Script script;
+    script.source_ = script_.source_;
+    script.statements_.reserve(script_.statements_.size());
+    Binder binder(&parameters, nullptr, script.arena_);
+    for (const auto& statement : script_.statements_) {
+        auto bound = binder.bind(statement);
+        if (!bound) {
+            return std::nullopt;
+        }
+        script.statements_.push_back(std::move(*bound));
+    }
+    return script;
+}
+
+Script PreparedStatement::bind_literals(
+    const std::vector<Value>& values) const {
+    Script script;
+    script.source_ = script_.source_;
+    script.parameter_count_ = script_.parameter_count_;
+    script.statements_.reserve(script_.statements_.size());
+    Binder binder(nullptr, &values, script.arena_);
+    for (const auto& statement : script_.statements_) {
+        auto bound = binder.bind(statement);
+        assert(bound);
+        script.statements_.push_back(std::move(*bound));
+    }
+    assert(binder.done());
+    return script;
+}
+
+PrepareResult prepare_sql(std::string_view input) {
+    Lexer lexer(ScriptSource::from_text(std::string(input)));
+    Parser parser(lexer);
+    auto parsed = parser.parse_sql_script();
+
+    PrepareResult result;
+    result.errors_ = std::move(parsed.errors_);
+    result.line_index_ = std::move(parsed.line_index_);
+    result.source_ = parsed.script.source_;
+    if (result.errors_.empty()) {
+        result.statement.emplace(std::move(parsed.script));
+    }
+    return result;
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <librdb/parser/Diagnostic.hpp>
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Statements.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::parser {
+
+// A script parsed once whose parameters and literals can be replaced
+// without lexing or parsing it again. Immutable, so one instance can be
+// bound from many threads.
+class PreparedStatement {
+   public:
+    // `script` must have been parsed without errors, and its lexemes must
+    // stay valid as long as it holds their source.
+    explicit PreparedStatement(Script script) : script_(std::move(script)) {}
+
+    const Script& script() const { return script_; }
+    size_t parameter_count() const { return script_.parameter_count_; }
+
+    // A copy of the script with parameters[i] in place of every Parameter
+    // with index i. TEXT parameters are given without quotes and copied
+    // into the result. std::nullopt if the number of parameters is not
+    // parameter_count() or an INSERT column would get both TEXT and
+    // numbers.
+    std::optional<Script> bind(const std::vector<Value>& parameters) const;
+
+    // A copy of the script with values[i] in place of its i-th literal;
+    // parameters are kept. values[i] must hold the type the literal parsed
+    // to (TEXT keeps its quotes and is not copied).
+    Script bind_literals(const std::vector<Value>& values) const;
+
+   private:
+    Script script_;
+};
+
+// Like Parser::Result, for prepare_sql().
+struct PrepareResult {
+    std::optional<PreparedStatement> statement;
+    std::vector<Diagnostic> errors_;
+    std::shared_ptr<const LineIndex> line_index_;
+    // The copy of the input that errors_ and line_index_ point into.
+    std::shared_ptr<const ScriptSource> source_;
+};
+
+// Parses `input`, which may hold `?` and `$N` placeholders wherever a value
+// is accepted. The statement keeps its own copy of `input`; on errors it
+// is not set and the diagnostics point into the copy.
+PrepareResult prepare_sql(std::string_view input);
+
+}  // namespace rdb::parser
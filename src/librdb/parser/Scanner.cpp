@@ -0,0 +1,275 @@
+#include <librdb/parser/Scanner.hpp>
+
+#include <librdb/parser/CharClass.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RDB_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace rdb::parser {
+
+namespace {
+
+using ScanFunction = size_t (*)(std::string_view, size_t);
+
+struct ScanFunctions {
+    ScanFunction spaces;
+    ScanFunction alnum;
+    ScanFunction string_body;
+    ScanFunction statement_body;
+};
+
+size_t scan_spaces_scalar(std::string_view input, size_t offset) {
+    while ((offset < input.size()) &&
+           is_space(input[offset])) {
+        ++offset;
+    }
+    return offset;
+}
+
+size_t scan_alnum_scalar(std::string_view input, size_t offset) {
+    while ((offset < input.size()) &&
+           is_alnum(input[offset])) {
+        ++offset;
+    }
+    return offset;
+}
+
+size_t scan_string_body_scalar(std::string_view input, size_t offset) {
+    while ((offset < input.size()) && (input[offset] != '"') &&
+           (input[offset] != '\n')) {
+        ++offset;
+    }
+    return offset;
+}
+
+size_t scan_statement_body_scalar(std::string_view input, size_t offset) {
+    while ((offset < input.size()) && (input[offset] != ';') &&
+           (input[offset] != '"')) {
+        ++offset;
+    }
+    return offset;
+}
+
+#ifdef RDB_SCANNER_X86
+
+const int sse_width = 16;
+const int avx_width = 32;
+
+// pcmpestri returns the index of the first byte outside `ranges` (negative
+// polarity) or 16 if the whole block belongs to the run.
+template <int Mode>
+__attribute__((target("sse4.2"))) size_t scan_sse42(
+    std::string_view input,
+    size_t offset,
+    __m128i set,
+    int set_size) {
+    while (offset + sse_width <= input.size()) {
+        const __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(input.data() + offset));
+        const int index =
+            _mm_cmpestri(set, set_size, block, sse_width, Mode);
+        offset += static_cast<size_t>(index);
+        if (index != sse_width) {
+            return offset;
+        }
+    }
+    return offset;
+}
+
+const int sse_in_ranges = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+    _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+const int sse_not_in_set =
+    _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+
+__attribute__((target("sse4.2"))) size_t scan_spaces_sse42(
+    std::string_view input,
+    size_t offset) {
+    const __m128i ranges =
+        _mm_setr_epi8('\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    offset = scan_sse42<sse_in_ranges>(input, offset, ranges, 4);
+    return scan_spaces_scalar(input, offset);
+}
+
+__attribute__((target("sse4.2"))) size_t scan_alnum_sse42(
+    std::string_view input,
+    size_t offset) {
+    const __m128i ranges = _mm_setr_epi8(
+        'a', 'z', 'A', 'Z', '0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    offset = scan_sse42<sse_in_ranges>(input, offset, ranges, 6);
+    return scan_alnum_scalar(input, offset);
+}
+
+__attribute__((target("sse4.2"))) size_t scan_string_body_sse42(
+    std::string_view input,
+    size_t offset) {
+    const __m128i stops =
+        _mm_setr_epi8('"', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    offset = scan_sse42<sse_not_in_set>(input, offset, stops, 2);
+    return scan_string_body_scalar(input, offset);
+}
+
+__attribute__((target("sse4.2"))) size_t scan_statement_body_sse42(
+    std::string_view input,
+    size_t offset) {
+    const __m128i stops =
+        _mm_setr_epi8(';', '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    offset = scan_sse42<sse_not_in_set>(input, offset, stops, 2);
+    return scan_statement_body_scalar(input, offset);
+}
+
+// Unsigned `lo <= x <= lo + span` for every byte.
+__attribute__((target("avx2"))) __m256i in_range_avx2(
+    __m256i block,
+    char lo,
+    char span) {
+    const __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(
+        _mm256_min_epu8(shifted, _mm256_set1_epi8(span)), shifted);
+}
+
+// Advances while `Classify` marks every byte of a 32-byte block as part of
+// the run, then stops at the first byte that is not.
+template <typename Classify>
+__attribute__((target("avx2"))) size_t scan_avx2(
+    std::string_view input,
+    size_t offset,
+    Classify classify) {
+    while (offset + avx_width <= input.size()) {
+        const __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(input.data() + offset));
+        const auto in_run =
+            static_cast<uint32_t>(_mm256_movemask_epi8(classify(block)));
+        if (in_run != UINT32_MAX) {
+            return offset + static_cast<size_t>(__builtin_ctz(~in_run));
+        }
+        offset += avx_width;
+    }
+    return offset;
+}
+
+struct SpacesAvx2 {
+    __attribute__((target("avx2"))) __m256i operator()(__m256i block) const {
+        return _mm256_or_si256(
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+            in_range_avx2(block, '\t', '\r' - '\t'));
+    }
+};
+
+struct AlnumAvx2 {
+    __attribute__((target("avx2"))) __m256i operator()(__m256i block) const {
+        const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+        return _mm256_or_si256(
+            in_range_avx2(lower, 'a', 'z' - 'a'),
+            in_range_avx2(block, '0', '9' - '0'));
+    }
+};
+
+// Bytes other than `First` and `Second`.
+template <char First, char Second>
+struct NoneOfAvx2 {
+    __attribute__((target("avx2"))) __m256i operator()(__m256i block) const {
+        const __m256i stop = _mm256_or_si256(
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8(First)),
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8(Second)));
+        return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+    }
+};
+
+__attribute__((target("avx2"))) size_t scan_spaces_avx2(
+    std::string_view input,
+    size_t offset) {
+    offset = scan_avx2(input, offset, SpacesAvx2());
+    return scan_spaces_scalar(input, offset);
+}
+
+__attribute__((target("avx2"))) size_t scan_alnum_avx2(
+    std::string_view input,
+    size_t offset) {
+    offset = scan_avx2(input, offset, AlnumAvx2());
+    return scan_alnum_scalar(input, offset);
+}
+
+__attribute__((target("avx2"))) size_t scan_string_body_avx2(
+    std::string_view input,
+    size_t offset) {
+    offset = scan_avx2(input, offset, NoneOfAvx2<'"', '\n'>());
+    return scan_string_body_scalar(input, offset);
+}
+
+__attribute__((target("avx2"))) size_t scan_statement_body_avx2(
+    std::string_view input,
+    size_t offset) {
+    offset = scan_avx2(input, offset, NoneOfAvx2<';', '"'>());
+    return scan_statement_body_scalar(input, offset);
+}
+
+#endif  // RDB_SCANNER_X86
+
+ScanFunctions select_scan_functions() {
+#ifdef RDB_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") != 0) {
+        return {
+            scan_spaces_avx2,
+            scan_alnum_avx2,
+            scan_string_body_avx2,
+            scan_statement_body_avx2};
+    }
+    if (__builtin_cpu_supports("sse4.2") != 0) {
+        return {
+            scan_spaces_sse42,
+            scan_alnum_sse42,
+            scan_string_body_sse42,
+            scan_statement_body_sse42};
+    }
+#endif
+    return {
+        scan_spaces_scalar,
+        scan_alnum_scalar,
+        scan_string_body_scalar,
+        scan_statement_body_scalar};
+}
+
+const ScanFunctions scan_functions = select_scan_functions();
+
+}  // namespace
+
+size_t scan_spaces(std::string_view input, size_t offset) {
+    return scan_functions.spaces(input, offset);
+}
+
+size_t scan_alnum(std::string_view input, size_t offset) {
+    return scan_functions.alnum(input, offset);
+}
+
+size_t scan_string_body(std::string_view input, size_t offset) {
+    return scan_functions.string_body(input, offset);
+}
+
+size_t scan_statement_body(std::string_view input, size_t offset) {
+    return scan_functions.statement_body(input, offset);
+}
+
+size_t find_statement_end(std::string_view input, size_t offset) {
+    while (true) {
+        offset = scan_statement_body(input, offset);
+        if (offset == input.size()) {
+            return offset;
+        }
+        if (input[offset] == ';') {
+            return offset + 1;
+        }
+        offset = scan_string_body(input, offset + 1);
+        if ((offset < input.size()) && (input[offset] == '"')) {
+            ++offset;
+        }
+    }
+}
+
+}  // namespace rdb::parser
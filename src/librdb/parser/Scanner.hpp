@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace rdb::parser {
+
+// Each function returns the offset of the first byte at or after `offset`
+// that does not continue the run (or input.size()). The widest
+// implementation supported by the CPU (AVX2, SSE4.2 or scalar) is picked
+// once at startup.
+
+// Runs of ' ', '\t', '\n', '\v', '\f' and '\r'.
+size_t scan_spaces(std::string_view input, size_t offset);
+
+// Runs of [A-Za-z0-9].
+size_t scan_alnum(std::string_view input, size_t offset);
+
+// Runs of anything but '"' and '\n'.
+size_t scan_string_body(std::string_view input, size_t offset);
+
+// Runs of anything but ';' and '"'.
+size_t scan_statement_body(std::string_view input, size_t offset);
+
+// Offset just past the first ';' at or after `offset` that is not inside a
+// string literal, or input.size(). Like the lexer, a string ends at its
+// closing '"' or before the next '\n'. `offset` must not be inside a string.
+size_t find_statement_end(std::string_view input, size_t offset);
+
+}  // namespace rdb::parser
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <librdb/parser/AstArena.hpp>
+#include <librdb/parser/ScriptSource.hpp>
 #include <librdb/parser/Statements.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace rdb::parser {
 
 struct Script {
-    std::vector<StatementPtr> statements_;
+    // Mapped input the lexemes point into, if it was parsed from a file.
+    std::shared_ptr<const ScriptSource> source_;
+    // Owns every list in statements_.
+    AstArena arena_;
+    std::vector<Statement> statements_;
+    // Values PreparedStatement::bind() needs: one more than the largest
+    // Parameter index in statements_, or 0.
+    size_t parameter_count_ = 0;
 };
 
 }  // namespace rdb::parser
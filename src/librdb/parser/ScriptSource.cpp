@@ -0,0 +1,110 @@
+#include <librdb/parser/ScriptSource.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rdb::parser {
+
+namespace {
+
+class FileDescriptor {
+   public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    FileDescriptor(FileDescriptor&&) = delete;
+    FileDescriptor& operator=(FileDescriptor&&) = delete;
+    ~FileDescriptor() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    int get() const { return fd_; }
+
+   private:
+    int fd_;
+};
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Reads `fd` to its end.
+std::string read_all(int fd, const std::string& path) {
+    constexpr size_t chunk_size = 64 * 1024;
+    std::string text;
+    for (;;) {
+        const size_t size = text.size();
+        text.resize(size + chunk_size);
+        const ssize_t count = read(fd, text.data() + size, chunk_size);
+        if (count < 0 && errno == EINTR) {
+            text.resize(size);
+            continue;
+        }
+        if (count < 0) {
+            throw_errno("read " + path);
+        }
+        text.resize(size + static_cast<size_t>(count));
+        if (count == 0) {
+            return text;
+        }
+    }
+}
+
+}  // namespace
+
+ScriptSource::ScriptSource(const std::string& path) {
+    const FileDescriptor fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0) {
+        throw_errno("open " + path);
+    }
+
+    struct stat info {};
+    if (fstat(fd.get(), &info) != 0) {
+        throw_errno("stat " + path);
+    }
+    // Pipes, FIFOs and files such as those in /proc report no size and
+    // cannot be mapped.
+    if (!S_ISREG(info.st_mode) || info.st_size == 0) {
+        text_ = read_all(fd.get(), path);
+        return;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw_errno("mmap " + path);
+    }
+
+    // Both are hints: the lexer reads front to back exactly once, and large
+    // pages cut TLB misses on multi-GB scripts where the kernel allows them.
+    madvise(data_, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+std::shared_ptr<const ScriptSource> ScriptSource::from_text(std::string text) {
+    std::shared_ptr<ScriptSource> source(new ScriptSource());
+    source->text_ = std::move(text);
+    return source;
+}
+
+ScriptSource::~ScriptSource() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace rdb::parser {
+
+// A script file mapped read-only into memory, or a script text owned in
+// memory. Files that cannot be mapped, e.g. pipes, are read into memory
+// whole; StreamParser parses a stream without holding all of it.
+// Lexemes, statements and errors parsed from text() point straight into
+// it, so a Script parsed from it keeps the source alive (see
+// Script::source_).
+class ScriptSource {
+   public:
+    // Throws std::system_error if the file cannot be opened, mapped or
+    // read.
+    explicit ScriptSource(const std::string& path);
+    // Takes ownership of `text`, e.g. a batch read from a stream.
+    static std::shared_ptr<const ScriptSource> from_text(std::string text);
+    ScriptSource(const ScriptSource&) = delete;
+    ScriptSource& operator=(const ScriptSource&) = delete;
+    ScriptSource(ScriptSource&&) = delete;
+    ScriptSource& operator=(ScriptSource&&) = delete;
+    ~ScriptSource();
+
+    std::string_view text() const {
+        if (data_ == nullptr) {
+            return text_;
+        }
+        return {static_cast<const char*>(data_), size_};
+    }
+
+   private:
+    ScriptSource() = default;
+
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    std::string text_;
+};
+
+}  // namespace rdb::parser
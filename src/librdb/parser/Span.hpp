@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+namespace rdb::parser {
+
+// Non-owning view over a contiguous array, e.g. a list carved from an
+// AstArena.
+template <typename T>
+class Span {
+   public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    T& front() const {
+        assert(!empty());
+        return data_[0];
+    }
+
+    T& operator[](size_t index) const {
+        assert(index < size_);
+        return data_[index];
+    }
+
+   private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace rdb::parser
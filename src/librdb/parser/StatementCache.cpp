@@ -0,0 +1,173 @@
+#include <librdb/parser/StatementCache.hpp>
+
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Numbers.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/PreparedStatement.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Statements.hpp>
+#include <librdb/parser/Token.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::parser {
+
+namespace {
+
+bool is_literal(Token::Kind kind) {
+    return (kind == Token::Kind::Int) || (kind == Token::Kind::Real) ||
+        (kind == Token::Kind::Text);
+}
+
+// The fingerprint and literal tokens of one input, collected in a single
+// lexer pass. Reused per thread, so a cache hit allocates no scratch.
+struct Shape {
+    std::string fingerprint;
+    std::vector<Token> literals;
+    std::vector<Value> values;
+};
+
+void scan_shape(std::string_view input, Shape& shape) {
+    shape.fingerprint.clear();
+    shape.literals.clear();
+    Lexer lexer(input);
+    while (true) {
+        const Token token = lexer.get();
+        const Token::Kind kind = token.type();
+        shape.fingerprint += static_cast<char>(kind);
+        if (is_literal(kind)) {
+            shape.literals.push_back(token);
+        } else if (
+            (kind == Token::Kind::Id) || (kind == Token::Kind::Param) ||
+            (kind == Token::Kind::Unknown)) {
+            // Lexemes never contain '\0', so it cannot be forged.
+            shape.fingerprint += token.lexeme();
+            shape.fingerprint += '\0';
+        } else if (kind == Token::Kind::Eof) {
+            return;
+        }
+    }
+}
+
+// Converts shape.literals into shape.values; false if one does not fit,
+// which the parser then reports.
+bool convert_literals(Shape& shape) {
+    shape.values.clear();
+    for (const Token& token : shape.literals) {
+        switch (token.type()) {
+            case Token::Kind::Int: {
+                const auto number = parse_int(token.lexeme());
+                if (!number) {
+                    return false;
+                }
+                shape.values.emplace_back(*number);
+                break;
+            }
+            case Token::Kind::Real: {
+                const auto number = parse_real(token.lexeme());
+                if (!number) {
+                    return false;
+                }
+                shape.values.emplace_back(*number);
+                break;
+            }
+            default:
+                shape.values.emplace_back(token.lexeme());
+                break;
+        }
+    }
+    return true;
+}
+
+Parser::Result parse_uncached(std::string_view input) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    return parser.parse_sql_script();
+}
+
+}  // namespace
+
+std::string fingerprint(std::string_view input) {
+    Shape shape;
+    scan_shape(input, shape);
+    return shape.fingerprint;
+}
+
+Parser::Result StatementCache::parse(std::string_view input) {
+    thread_local Shape shape;
+    scan_shape(input, shape);
+
+    auto statement = find(shape.fingerprint);
+    if (statement == nullptr) {
+        // The cached statement must not point into the caller's input.
+        auto source = ScriptSource::from_text(std::string(input));
+        Lexer lexer(source);
+        Parser parser(lexer);
+        auto prepared = parser.parse_sql_script();
+        if (!prepared.errors_.empty()) {
+            return parse_uncached(input);
+        }
+
+        statement = std::make_shared<const PreparedStatement>(
+            std::move(prepared.script));
+        insert(shape.fingerprint, statement);
+    }
+
+    if (!convert_literals(shape)) {
+        return parse_uncached(input);
+    }
+    Parser::Result result;
+    result.script = statement->bind_literals(shape.values);
+    return result;
+}
+
+size_t StatementCache::size() const {
+    const std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+size_t StatementCache::hits() const {
+    const std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+size_t StatementCache::misses() const {
+    const std::lock_guard lock(mutex_);
+    return misses_;
+}
+
+std::shared_ptr<const PreparedStatement> StatementCache::find(
+    std::string_view fingerprint) {
+    const std::lock_guard lock(mutex_);
+    const auto it = index_.find(fingerprint);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->statement;
+}
+
+void StatementCache::insert(
+    std::string fingerprint,
+    std::shared_ptr<const PreparedStatement> statement) {
+    const std::lock_guard lock(mutex_);
+    if ((capacity_ == 0) || (index_.find(fingerprint) != index_.end())) {
+        return;
+    }
+    if (entries_.size() == capacity_) {
+        index_.erase(entries_.back().fingerprint);
+        entries_.pop_back();
+    }
+    entries_.push_front({std::move(fingerprint), std::move(statement)});
+    index_.emplace(entries_.front().fingerprint, entries_.begin());
+}
+
+}  // namespace rdb::parser
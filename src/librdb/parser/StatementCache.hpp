@@ -0,0 +1,63 @@
+#pragma once
+
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/PreparedStatement.hpp>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rdb::parser {
+
+inline constexpr size_t default_statement_cache_capacity = 1024;
+
+// The shape of `input` with every literal replaced by a placeholder of its
+// kind: token kinds, plus the lexemes of identifiers, parameters and
+// unknown tokens. Inputs with the same fingerprint parse into the same
+// statements up to their literal values.
+std::string fingerprint(std::string_view input);
+
+// A bounded, thread-safe LRU cache from fingerprint to PreparedStatement.
+// A hit lexes the input once and binds its literals into the cached
+// statement; only misses run the parser.
+class StatementCache {
+   public:
+    explicit StatementCache(
+        size_t capacity = default_statement_cache_capacity)
+        : capacity_(capacity) {}
+
+    // Same result as Parser(Lexer(input)).parse_sql_script(). TEXT values
+    // point into `input`; identifiers may point into the cached copy of
+    // the input that was parsed first, which the Script keeps alive.
+    Parser::Result parse(std::string_view input);
+
+    size_t size() const;
+    size_t hits() const;
+    size_t misses() const;
+
+   private:
+    struct Entry {
+        std::string fingerprint;
+        std::shared_ptr<const PreparedStatement> statement;
+    };
+
+    std::shared_ptr<const PreparedStatement> find(
+        std::string_view fingerprint);
+    void insert(
+        std::string fingerprint,
+        std::shared_ptr<const PreparedStatement> statement);
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    // Most recently used first. Map keys point into the entries.
+    std::list<Entry> entries_;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+}  // namespace rdb::parser
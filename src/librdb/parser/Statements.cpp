@@ -1,32 +1,56 @@
 #include <librdb/parser/Statements.hpp>
 
-#include <sstream>
+#include <librdb/parser/OutputBuffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <variant>
 
 namespace rdb::parser {
 
-Statement::~Statement() = default;
-
-static std::string value_to_str(const Value& value) {
+static void format_value(OutputBuffer& out, const Value& value) {
     if (const int32_t* pval = std::get_if<int32_t>(&value)) {
-        return std::to_string(*pval);
+        out.append(*pval);
+    } else if (const float* pval = std::get_if<float>(&value)) {
+        out.append(*pval);
+    } else if (const Parameter* pval = std::get_if<Parameter>(&value)) {
+        out.append('$');
+        out.append(static_cast<int32_t>(pval->index_ + 1));
+    } else {
+        out.append(*std::get_if<std::string_view>(&value));
+    }
+}
+
+Value ValueColumn::value(size_t row) const {
+    if (has_parameters()) {
+        return values_[row];
     }
-    if (const float* pval = std::get_if<float>(&value)) {
-        return std::to_string(*pval);
+    switch (type_) {
+        case ColumnDef::Type::Int:
+            return ints_[row];
+        case ColumnDef::Type::Real:
+            return reals_[row];
+        case ColumnDef::Type::Text:
+            return texts_[row];
     }
-    return std::string(*std::get_if<std::string_view>(&value));
+    return texts_[row];
 }
 
-static std::string operand_to_str(const Expression::Operand& operand) {
+static void format_operand(
+    OutputBuffer& out,
+    const Expression::Operand& operand) {
     if (const std::string_view* pval =
             std::get_if<std::string_view>(&operand)) {
-        return std::string(*pval);
+        out.append(*pval);
+    } else {
+        format_value(out, *std::get_if<Value>(&operand));
     }
-    return value_to_str(*std::get_if<Value>(&operand));
 }
 
-static std::string operation_to_str(const Expression::Operation& operation) {
+static std::string_view operation_to_str(
+    const Expression::Operation& operation) {
     switch (operation) {
         case Expression::Operation::Lte:
             return "<=";
@@ -44,13 +68,17 @@ static std::string operation_to_str(const Expression::Operation& operation) {
     return "Unexpected";
 }
 
-static std::string expression_to_str(const Expression& expression) {
-    return operand_to_str(expression.left_) + " " +
-           operation_to_str(expression.operation_) + " " +
-           operand_to_str(expression.right_);
+static void format_expression(
+    OutputBuffer& out,
+    const Expression& expression) {
+    format_operand(out, expression.left_);
+    out.append(' ');
+    out.append(operation_to_str(expression.operation_));
+    out.append(' ');
+    format_operand(out, expression.right_);
 }
 
-static std::string column_def_type_to_str(const ColumnDef::Type type) {
+static std::string_view column_def_type_to_str(const ColumnDef::Type type) {
     switch (type) {
         case ColumnDef::Type::Int:
             return "INT";
@@ -62,71 +90,98 @@ static std::string column_def_type_to_str(const ColumnDef::Type type) {
     return "Unexpected";
 }
 
-static std::string column_def_to_str(const ColumnDef& column_def) {
-    return std::string(column_def.column_name_) + " " +
-           column_def_type_to_str(column_def.type_);
+static void format_column_def(OutputBuffer& out, const ColumnDef& column_def) {
+    out.append(column_def.column_name_);
+    out.append(' ');
+    out.append(column_def_type_to_str(column_def.type_));
 }
 
-std::string CreateTableStatement::to_string() const {
-    std::stringstream out;
+void CreateTableStatement::format_to(OutputBuffer& out) const {
     auto column_def = column_defs().begin();
-    out << "CREATE TABLE " << table_name() << " ("
-        << column_def_to_str(*column_def);
+    out.append("CREATE TABLE ");
+    out.append(table_name());
+    out.append(" (");
+    format_column_def(out, *column_def);
     for (column_def++; column_def != column_defs().end(); column_def++) {
-        out << ", " << column_def_to_str(*column_def);
+        out.append(", ");
+        format_column_def(out, *column_def);
     }
-    out << ");";
-
-    return out.str();
+    out.append(");");
 }
 
-std::string SelectStatement::to_string() const {
-    std::stringstream out;
-    out << "SELECT ";
+void SelectStatement::format_to(OutputBuffer& out) const {
+    out.append("SELECT ");
     for (auto column_name : column_names()) {
-        out << column_name << " ";
+        out.append(column_name);
+        out.append(' ');
     }
-    out << "FROM " << table_name();
+    out.append("FROM ");
+    out.append(table_name());
     if (expression()) {
-        out << " WHERE " << expression_to_str(*expression());
+        out.append(" WHERE ");
+        format_expression(out, *expression());
     }
-    out << ";";
-
-    return out.str();
+    out.append(';');
 }
 
-std::string InsertStatement::to_string() const {
-    std::stringstream out;
+void InsertStatement::format_to(OutputBuffer& out) const {
     auto column_name = column_names().begin();
-    out << "INSERT INTO " << table_name() << " (" << *column_name;
+    out.append("INSERT INTO ");
+    out.append(table_name());
+    out.append(" (");
+    out.append(*column_name);
     for (column_name++; column_name != column_names().end(); column_name++) {
-        out << ", " << *column_name;
+        out.append(", ");
+        out.append(*column_name);
     }
-    auto value = values().begin();
-    out << ") VALUES (" << value_to_str(*value);
-    for (value++; value != values().end(); value++) {
-        out << ", " << value_to_str(*value);
+    out.append(") VALUES ");
+    for (size_t row = 0; row < row_count(); ++row) {
+        out.append(row == 0 ? "(" : ", (");
+        format_value(out, value(row, 0));
+        for (size_t column = 1; column < columns().size(); ++column) {
+            out.append(", ");
+            format_value(out, value(row, column));
+        }
+        out.append(')');
     }
-    out << ");";
-
-    return out.str();
+    out.append(';');
 }
 
-std::string DeleteStatement::to_string() const {
-    std::stringstream out;
-    out << "DELETE FROM " << table_name();
+void DeleteStatement::format_to(OutputBuffer& out) const {
+    out.append("DELETE FROM ");
+    out.append(table_name());
     if (expression()) {
-        out << " WHERE " << expression_to_str(*expression());
+        out.append(" WHERE ");
+        format_expression(out, *expression());
     }
-    out << ";";
+    out.append(';');
+}
+
+void DropTableStatement::format_to(OutputBuffer& out) const {
+    out.append("DROP TABLE ");
+    out.append(table_name());
+    out.append(';');
+}
+
+void CreateIndexStatement::format_to(OutputBuffer& out) const {
+    out.append("CREATE INDEX ");
+    out.append(index_name());
+    out.append(" ON ");
+    out.append(table_name());
+    out.append(" (");
+    out.append(column_name());
+    out.append(method() == Method::Hash ? ") USING HASH;" : ") USING BTREE;");
+}
 
-    return out.str();
+void format_to(OutputBuffer& out, const Statement& statement) {
+    std::visit([&](const auto& alternative) { alternative.format_to(out); },
+               statement);
 }
 
-std::string DropTableStatement::to_string() const {
-    std::stringstream out;
-    out << "DROP TABLE " << table_name() << ";";
-    return out.str();
+std::string to_string(const Statement& statement) {
+    OutputBuffer out;
+    format_to(out, statement);
+    return std::string(out.view());
 }
 
 }  // namespace rdb::parser
@@ -1,13 +1,14 @@
 #pragma once
 
-#include <cstdlib>
-#include <exception>
-#include <memory>
+#include <librdb/parser/OutputBuffer.hpp>
+#include <librdb/parser/Span.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <variant>
-#include <vector>
 
 namespace rdb::parser {
 
@@ -21,7 +22,39 @@ struct ColumnDef {
     Type type_;
 };
 
-using Value = std::variant<int32_t, float, std::string_view>;
+// Placeholders are numbered from 1 up to this.
+inline constexpr uint32_t max_parameters = 65535;
+
+// A `?` or `$N` placeholder for a value supplied by PreparedStatement::bind.
+// `$N` has index N - 1; `?` takes the index after the largest one seen so
+// far in its script.
+struct Parameter {
+    uint32_t index_;
+
+    bool operator==(Parameter other) const { return index_ == other.index_; }
+    bool operator!=(Parameter other) const { return index_ != other.index_; }
+};
+
+using Value = std::variant<int32_t, float, std::string_view, Parameter>;
+
+// The values of one INSERT column in every row, stored contiguously by
+// type. Only the span matching type_ is set. An INT literal in a column
+// that also holds REAL literals is stored as float.
+//
+// A column with a Parameter in any row is kept as written in values_
+// instead, since its type is only known once it is bound; type_ is then
+// meaningless.
+struct ValueColumn {
+    ColumnDef::Type type_;
+    Span<const int32_t> ints_;
+    Span<const float> reals_;
+    Span<const std::string_view> texts_;
+    Span<const Value> values_;
+
+    bool has_parameters() const { return !values_.empty(); }
+
+    Value value(size_t row) const;
+};
 
 struct Expression {
     enum class Operation {
@@ -38,45 +71,35 @@ struct Expression {
     Operand right_;
 };
 
-class Statement {
-   public:
-    virtual ~Statement() = 0;
-    virtual std::string to_string() const = 0;
-};
-
-using StatementPtr = std::unique_ptr<const Statement>;
-
-class CreateTableStatement : public Statement {
+class CreateTableStatement {
    public:
     CreateTableStatement(
         const std::string_view table_name,
-        const std::vector<ColumnDef>& column_defs)
+        const Span<const ColumnDef> column_defs)
         : table_name_(table_name), column_defs_(column_defs) {}
 
     std::string_view table_name() const { return table_name_; }
 
-    const std::vector<ColumnDef>& column_defs() const { return column_defs_; }
+    Span<const ColumnDef> column_defs() const { return column_defs_; }
 
-    std::string to_string() const override;
+    void format_to(OutputBuffer& out) const;
 
    private:
     std::string_view table_name_;
-    std::vector<ColumnDef> column_defs_;
+    Span<const ColumnDef> column_defs_;
 };
 
-using CreateTableStatementPtr = std::unique_ptr<const CreateTableStatement>;
-
-class SelectStatement : public Statement {
+class SelectStatement {
    public:
     SelectStatement(
-        const std::vector<std::string_view>& column_names,
+        const Span<const std::string_view> column_names,
         const std::string_view table_name,
         const std::optional<Expression> expression = std::nullopt)
         : column_names_(column_names),
           table_name_(table_name),
           expression_(expression) {}
 
-    const std::vector<std::string_view>& column_names() const {
+    Span<const std::string_view> column_names() const {
         return column_names_;
     }
 
@@ -84,42 +107,48 @@ class SelectStatement : public Statement {
 
     std::optional<Expression> expression() const { return expression_; }
 
-    std::string to_string() const override;
+    void format_to(OutputBuffer& out) const;
 
    private:
-    std::vector<std::string_view> column_names_;
+    Span<const std::string_view> column_names_;
     std::string_view table_name_;
     std::optional<Expression> expression_;
 };
 
-using SelectStatementPtr = std::unique_ptr<const SelectStatement>;
-
-class InsertStatement : public Statement {
+// All rows of `INSERT ... VALUES (...), (...)` as a columnar batch: one
+// ValueColumn per name in column_names(), each row_count() long.
+class InsertStatement {
    public:
     InsertStatement(
         const std::string_view table_name,
-        const std::vector<std::string_view>& column_names,
-        const std::vector<Value>& values)
+        const Span<const std::string_view> column_names,
+        const Span<const ValueColumn> columns,
+        const size_t row_count)
         : table_name_(table_name),
           column_names_(column_names),
-          values_(values) {}
+          columns_(columns),
+          row_count_(row_count) {}
     std::string_view table_name() const { return table_name_; }
-    const std::vector<std::string_view>& column_names() const {
+    Span<const std::string_view> column_names() const {
         return column_names_;
     }
-    const std::vector<Value>& values() const { return values_; }
+    Span<const ValueColumn> columns() const { return columns_; }
+    size_t row_count() const { return row_count_; }
 
-    std::string to_string() const override;
+    Value value(size_t row, size_t column) const {
+        return columns_[column].value(row);
+    }
+
+    void format_to(OutputBuffer& out) const;
 
    private:
     std::string_view table_name_;
-    std::vector<std::string_view> column_names_;
-    std::vector<Value> values_;
+    Span<const std::string_view> column_names_;
+    Span<const ValueColumn> columns_;
+    size_t row_count_;
 };
 
-using InsertStatementPtr = std::unique_ptr<const InsertStatement>;
-
-class DeleteStatement : public Statement {
+class DeleteStatement {
    public:
     explicit DeleteStatement(
         const std::string_view table_name,
@@ -130,27 +159,82 @@ class DeleteStatement : public Statement {
 
     std::optional<Expression> expression() const { return expression_; }
 
-    std::string to_string() const override;
+    void format_to(OutputBuffer& out) const;
 
    private:
     std::string_view table_name_;
     std::optional<Expression> expression_;
 };
 
-using DeleteStatementPtr = std::unique_ptr<const DeleteStatement>;
-
-class DropTableStatement : public Statement {
+class DropTableStatement {
    public:
     explicit DropTableStatement(std::string_view table_name)
         : table_name_(table_name) {}
     std::string_view table_name() const { return table_name_; }
 
-    std::string to_string() const override;
+    void format_to(OutputBuffer& out) const;
 
    private:
     std::string_view table_name_;
 };
 
-using DropTableStatementPtr = std::unique_ptr<const DropTableStatement>;
+// `CREATE INDEX name ON table (column) [USING HASH | USING BTREE]`, a
+// BTREE when USING is left out.
+class CreateIndexStatement {
+   public:
+    enum class Method {
+        // Serves `=` and `!=`.
+        Hash,
+        // Serves every comparison.
+        BTree,
+    };
+
+    CreateIndexStatement(
+        const std::string_view index_name,
+        const std::string_view table_name,
+        const std::string_view column_name,
+        const Method method)
+        : index_name_(index_name),
+          table_name_(table_name),
+          column_name_(column_name),
+          method_(method) {}
+
+    std::string_view index_name() const { return index_name_; }
+    std::string_view table_name() const { return table_name_; }
+    std::string_view column_name() const { return column_name_; }
+    Method method() const { return method_; }
+
+    void format_to(OutputBuffer& out) const;
+
+   private:
+    std::string_view index_name_;
+    std::string_view table_name_;
+    std::string_view column_name_;
+    Method method_;
+};
+
+// Every statement kind, stored by value. Lists inside a statement live in
+// the AstArena of its Script. Dispatch with std::visit, e.g. through
+// Overloaded.
+using Statement = std::variant<
+    CreateTableStatement,
+    SelectStatement,
+    InsertStatement,
+    DeleteStatement,
+    DropTableStatement,
+    CreateIndexStatement>;
+
+// Combines lambdas into one visitor for std::visit.
+template <typename... Functions>
+struct Overloaded : Functions... {
+    using Functions::operator()...;
+};
+template <typename... Functions>
+Overloaded(Functions...) -> Overloaded<Functions...>;
+
+// Appends the statement as normalized SQL.
+void format_to(OutputBuffer& out, const Statement& statement);
+// format_to() a new string.
+std::string to_string(const Statement& statement);
 
 }  // namespace rdb::parser
@@ -0,0 +1,104 @@
+#include <librdb/parser/StreamParser.hpp>
+
+#include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/Parser.hpp>
+#include <librdb/parser/Scanner.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rdb::parser {
+
+void StreamParser::feed(std::string_view chunk) {
+    buffer_.append(chunk);
+
+    // Same walk as find_statement_end(), but it can stop inside a string
+    // and resume there when the next chunk arrives.
+    const std::string_view input = buffer_;
+    while (scanned_ < input.size()) {
+        if (in_string_) {
+            scanned_ = scan_string_body(input, scanned_);
+            if (scanned_ == input.size()) {
+                break;
+            }
+            if (input[scanned_] == '"') {
+                ++scanned_;
+            }
+            in_string_ = false;
+            continue;
+        }
+        scanned_ = scan_statement_body(input, scanned_);
+        if (scanned_ == input.size()) {
+            break;
+        }
+        in_string_ = (input[scanned_] == '"');
+        ++scanned_;
+        if (!in_string_) {
+            statements_end_ = scanned_;
+        }
+    }
+
+    if (statements_end_ > 0) {
+        parse_batch(statements_end_);
+    }
+}
+
+void StreamParser::finish() {
+    if (!buffer_.empty()) {
+        parse_batch(buffer_.size());
+    }
+    in_string_ = false;
+}
+
+void StreamParser::parse_batch(size_t end) {
+    std::string text = std::move(buffer_);
+    buffer_.assign(text, end, std::string::npos);
+    text.resize(end);
+    scanned_ -= end;
+    statements_end_ = 0;
+
+    auto source = ScriptSource::from_text(std::move(text));
+    const std::string_view batch = source->text();
+    const auto line_index =
+        std::make_shared<const LineIndex>(batch, row_, col_);
+
+    const auto newlines =
+        static_cast<size_t>(std::count(batch.begin(), batch.end(), '\n'));
+    if (newlines == 0) {
+        col_ += batch.size();
+    } else {
+        row_ += newlines;
+        col_ = batch.size() - batch.rfind('\n');
+    }
+
+    Lexer lexer(batch, 0, batch.size(), line_index);
+    Parser parser(lexer);
+    auto result = parser.parse_sql_script();
+    result.script.source_ = std::move(source);
+    if (!result.script.statements_.empty() || !result.errors_.empty()) {
+        callback_(std::move(result));
+    }
+}
+
+void parse_sql_stream(
+    std::istream& input,
+    StreamParser::Callback callback,
+    size_t chunk_size) {
+    StreamParser parser(std::move(callback));
+    std::string chunk(std::max<size_t>(chunk_size, 1), '\0');
+    while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           (input.gcount() > 0)) {
+        parser.feed(std::string_view(
+            chunk.data(), static_cast<size_t>(input.gcount())));
+    }
+    parser.finish();
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <librdb/parser/Parser.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rdb::parser {
+
+inline constexpr size_t default_stream_chunk_size = size_t(1) << 16;
+
+// Parses a script that arrives in pieces, e.g. from a pipe. Input is
+// buffered only up to the last top-level ';' seen, so memory stays bounded
+// by one chunk plus the longest statement. Complete statements are parsed
+// as soon as their ';' arrives and handed to the callback in input order.
+class StreamParser {
+   public:
+    // Receives the statements and errors of one batch of complete
+    // statements. The Script owns the batch text it points into. Error
+    // rows and columns are positions in the whole stream; offsets are
+    // relative to the batch.
+    using Callback = std::function<void(Parser::Result)>;
+
+    explicit StreamParser(Callback callback)
+        : callback_(std::move(callback)) {}
+
+    // Appends `chunk`, which may end anywhere, even inside a token.
+    void feed(std::string_view chunk);
+    // Parses whatever follows the last ';' as the end of the script.
+    void finish();
+
+   private:
+    // Parses buffer_[0, end) and keeps the rest for later input.
+    void parse_batch(size_t end);
+
+    Callback callback_;
+    std::string buffer_;
+    // buffer_ has been scanned for ';' up to here.
+    size_t scanned_ = 0;
+    bool in_string_ = false;
+    // End of the last complete statement in buffer_.
+    size_t statements_end_ = 0;
+    // Position of buffer_[0] in the stream.
+    size_t row_ = 1;
+    size_t col_ = 1;
+};
+
+// Feeds `input` to a StreamParser in reads of `chunk_size` bytes.
+void parse_sql_stream(
+    std::istream& input,
+    StreamParser::Callback callback,
+    size_t chunk_size = default_stream_chunk_size);
+
+}  // namespace rdb::parser
@@ -1,11 +1,35 @@
+#include <librdb/parser/AstArena.hpp>
+#include <librdb/parser/BinaryScript.hpp>
 #include <librdb/parser/Lexer.hpp>
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/Numbers.hpp>
+#include <librdb/parser/OutputBuffer.hpp>
+#include <librdb/parser/ParallelParser.hpp>
 #include <librdb/parser/Parser.hpp>
+#include <librdb/parser/PreparedStatement.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/StatementCache.hpp>
+#include <librdb/parser/StreamParser.hpp>
+#include <librdb/parser/TokenBuffer.hpp>
 
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
 #include <variant>
+#include <vector>
+
+#include <sys/stat.h>
 
 #include <gtest/gtest.h>
 
@@ -20,6 +44,23 @@ std::string get_tokens(const std::string_view input) {
     return out.str();
 }
 
+TEST(LexerSuite, LineIndexTest) {
+    const rdb::parser::LineIndex line_index("ab\n\ncd\n");
+    std::stringstream locations;
+    for (size_t offset = 0; offset <= 7; ++offset) {
+        locations << line_index.row(offset) << ":" << line_index.col(offset)
+                  << ' ';
+    }
+
+    EXPECT_EQ("1:1 1:2 1:3 2:1 3:1 3:2 3:3 4:1 ", locations.str());
+
+    const rdb::parser::LineIndex batch_index("ab\ncd", 5, 10);
+    EXPECT_EQ(5U, batch_index.row(1));
+    EXPECT_EQ(11U, batch_index.col(1));
+    EXPECT_EQ(6U, batch_index.row(4));
+    EXPECT_EQ(2U, batch_index.col(4));
+}
+
 TEST(LexerSuite, PeekGetTest) {
     rdb::parser::Lexer lexer("a b c\n d\n\n e");
     std::stringstream tokens;
@@ -78,6 +119,33 @@ TEST(LexerSuite, KwTest) {
     EXPECT_EQ(expcted_token, tokens);
 }
 
+TEST(LexerSuite, AllKwTest) {
+    const auto tokens = get_tokens(
+        "SELECT FROM DROP TABLE INSERT INTO VALUES DELETE WHERE CREATE INT "
+        "REAL TEXT Select INTEGER TEX");
+
+    const std::string expcted_token =
+        "KwSelect 'SELECT' Loc=1:1\n"
+        "KwFrom 'FROM' Loc=1:8\n"
+        "KwDrop 'DROP' Loc=1:13\n"
+        "KwTable 'TABLE' Loc=1:18\n"
+        "KwInsert 'INSERT' Loc=1:24\n"
+        "KwInto 'INTO' Loc=1:31\n"
+        "KwValues 'VALUES' Loc=1:36\n"
+        "KwDelete 'DELETE' Loc=1:43\n"
+        "KwWhere 'WHERE' Loc=1:50\n"
+        "KwCreate 'CREATE' Loc=1:56\n"
+        "KwInt 'INT' Loc=1:63\n"
+        "KwReal 'REAL' Loc=1:67\n"
+        "KwText 'TEXT' Loc=1:72\n"
+        "Id 'Select' Loc=1:77\n"
+        "Id 'INTEGER' Loc=1:84\n"
+        "Id 'TEX' Loc=1:92\n"
+        "Eof '<EOF>' Loc=1:95\n";
+
+    EXPECT_EQ(expcted_token, tokens);
+}
+
 TEST(LexerSuite, IntTest) {
     const auto tokens = get_tokens("123 -312 +0123 -k");
 
@@ -195,6 +263,101 @@ TEST(LexerSuite, OtherTokensTest) {
     EXPECT_EQ(expcted_token, tokens);
 }
 
+TEST(LexerSuite, ParamTest) {
+    const auto tokens = get_tokens("? $1 $23$ $x");
+
+    const std::string expected_tokens =
+        "Param '?' Loc=1:1\n"
+        "Param '$1' Loc=1:3\n"
+        "Param '$23' Loc=1:6\n"
+        "Unknown '$' Loc=1:9\n"
+        "Unknown '$' Loc=1:11\n"
+        "Id 'x' Loc=1:12\n"
+        "Eof '<EOF>' Loc=1:13\n";
+
+    EXPECT_EQ(expected_tokens, tokens);
+}
+
+TEST(LexerSuite, LongRunsTest) {
+    const std::string id(70, 'a');
+    const std::string text = "\"" + std::string(50, 'x') + "\"";
+    const std::string unterminated = "\"" + std::string(40, 'y');
+    const auto tokens = get_tokens(
+        std::string(33, ' ') + id + "Z9" + std::string(20, ' ') + "\n\t\n" +
+        std::string(40, ' ') + text + "\n" + unterminated + "\n" + id);
+
+    const std::string expcted_token = "Id '" + id + "Z9' Loc=1:34\n" +
+        "Text '" + text + "' Loc=3:41\n" + "Unknown '" + unterminated +
+        "' Loc=4:1\n" + "Id '" + id + "' Loc=5:1\n" + "Eof '<EOF>' Loc=5:71\n";
+
+    EXPECT_EQ(expcted_token, tokens);
+}
+
+TEST(LexerSuite, TokenizeAllTest) {
+    rdb::parser::Lexer lexer("SELECT a\nFROM t;");
+    const rdb::parser::TokenBuffer tokens = lexer.tokenize_all();
+    std::stringstream out;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        out << tokens.token(i) << '\n';
+    }
+
+    const std::string expcted_token =
+        "KwSelect 'SELECT' Loc=1:1\n"
+        "Id 'a' Loc=1:8\n"
+        "KwFrom 'FROM' Loc=2:1\n"
+        "Id 't' Loc=2:6\n"
+        "Semicolon ';' Loc=2:7\n"
+        "Eof '<EOF>' Loc=2:8\n";
+
+    EXPECT_EQ(expcted_token, out.str());
+}
+
+TEST(AstArenaSuite, AllocateTest) {
+    rdb::parser::AstArena arena;
+    const std::vector<double> small(3, 1.5);
+    const std::vector<double> large(10000, 2.5);
+
+    auto* byte = arena.create<char>('x');
+    const auto small_span = arena.copy(small);
+    const auto large_span = arena.copy(large);
+    const auto empty_span = arena.copy(std::vector<int>());
+
+    EXPECT_EQ('x', *byte);
+    EXPECT_EQ(
+        0U, reinterpret_cast<uintptr_t>(small_span.data()) % alignof(double));
+    EXPECT_EQ(3U, small_span.size());
+    EXPECT_EQ(1.5, small_span[2]);
+    EXPECT_EQ(10000U, large_span.size());
+    EXPECT_EQ(2.5, large_span[9999]);
+    EXPECT_TRUE(empty_span.empty());
+    EXPECT_GE(arena.bytes_allocated(), sizeof(double) * 10003);
+}
+
+TEST(AstArenaSuite, MoveTest) {
+    rdb::parser::AstArena arena;
+    const auto* value = arena.create<int>(7);
+
+    // A moved-from arena must allocate from blocks of its own, not from
+    // the spare room of the blocks it gave away.
+    rdb::parser::AstArena moved(std::move(arena));
+    EXPECT_EQ(0U, arena.bytes_allocated());
+    void* from_old = arena.allocate(16, 8);
+    void* from_new = moved.allocate(16, 8);
+    EXPECT_NE(from_old, from_new);
+    EXPECT_EQ(7, *value);
+
+    {
+        rdb::parser::AstArena assigned;
+        assigned.create<int>(1);
+        assigned = std::move(moved);
+        EXPECT_EQ(0U, moved.bytes_allocated());
+        EXPECT_EQ(7, *value);
+    }
+    // The blocks are gone with `assigned`; this must not write into them.
+    std::memset(moved.allocate(16, 8), 0, 16);
+    EXPECT_GT(moved.bytes_allocated(), 0U);
+}
+
 std::string get_parser_result(const std::string_view input) {
     rdb::parser::Lexer lexer(input);
     rdb::parser::Parser parser(lexer);
@@ -205,7 +368,7 @@ std::string get_parser_result(const std::string_view input) {
     std::stringstream out;
 
     for (const auto& i : result.script.statements_) {
-        out << i->to_string() << '\n';
+        out << rdb::parser::to_string(i) << '\n';
     }
 
     for (const auto& i : result.errors_) {
@@ -241,7 +404,7 @@ TEST(ParserSuite, CreateTableStatementTest) {
         "Expected LParen, got Id 'table' 6:21\n"
         "Expected Id, got LParen '(' 7:14\n"
         "Expected LParen, got KwText 'TEXT' 8:18\n"
-        "Expected KwTable, got Id 'table' 9:8\n"
+        "Expected TABLE or INDEX, got Id 'table' 9:8\n"
         "Expected CREATE, SELECT, INSERT, DELETE or DROP, got Id 'CRETE' 10:1\n"
         "Expected Id, got RParen ')' 11:21\n"
         "Expected LParen, got Semicolon ';' 12:19\n";
@@ -299,19 +462,196 @@ TEST(ParserSuite, InsertStatementTest) {
         "INSERT INTO t VALUES (12);\n"
         "INSERT INTO (n1) VALUES (12);\n"
         "INSERT INTO t (n1) VALUES;\n"
-        "INSERT INTO t (n1) (12);\n");
+        "INSERT INTO t (n1) (12);\n"
+        "INSERT INTO t (a, b) VALUES (1, \"x\"), (2.5, \"y\"), (-3, \"z\");\n"
+        "INSERT INTO t (a, b) VALUES (1, 2, 3);\n"
+        "INSERT INTO t (a, b) VALUES (1), (2, 3);\n"
+        "INSERT INTO t (a) VALUES (1), (\"s\");\n"
+        "INSERT INTO t (a) VALUES (\"s\"), (1);\n"
+        "INSERT INTO t (a) VALUES (1) (2);\n");
 
     const std::string expected_result =
         "INSERT INTO t (n1) VALUES (123);\n"
         "INSERT INTO t (n1, n2, n3) VALUES (12, 0.530000, \"str\");\n"
+        "INSERT INTO t (a, b) VALUES (1.000000, \"x\"), (2.500000, \"y\"), "
+        "(-3.000000, \"z\");\n"
         "Expected LParen, got KwValues 'VALUES' 3:15\n"
         "Expected Id, got LParen '(' 4:13\n"
         "Expected LParen, got Semicolon ';' 5:26\n"
-        "Expected KwValues, got LParen '(' 6:20\n";
+        "Expected KwValues, got LParen '(' 6:20\n"
+        "Expected RParen, got Comma ',' 8:34\n"
+        "Expected Comma, got RParen ')' 9:31\n"
+        "Expected Int or Real, got Text '\"s\"' 10:32\n"
+        "Expected Text, got Int '1' 11:34\n"
+        "Expected Semicolon, got LParen '(' 12:30\n";
+
+    EXPECT_EQ(expected_result, parser_result);
+}
+
+TEST(ParserSuite, NumbersTest) {
+    EXPECT_EQ(0, rdb::parser::parse_int("0"));
+    EXPECT_EQ(-7, rdb::parser::parse_int("-7"));
+    EXPECT_EQ(12345678, rdb::parser::parse_int("12345678"));
+    EXPECT_EQ(-123456789, rdb::parser::parse_int("-123456789"));
+    EXPECT_EQ(INT32_MAX, rdb::parser::parse_int("+2147483647"));
+    EXPECT_EQ(INT32_MIN, rdb::parser::parse_int("-2147483648"));
+    EXPECT_EQ(std::nullopt, rdb::parser::parse_int("2147483648"));
+    EXPECT_EQ(std::nullopt, rdb::parser::parse_int("-2147483649"));
+    EXPECT_EQ(std::nullopt, rdb::parser::parse_int("99999999999"));
+
+    EXPECT_EQ(0.5F, rdb::parser::parse_real("+0.5"));
+    EXPECT_EQ(-2.0F, rdb::parser::parse_real("-2."));
+    EXPECT_EQ(123.2F, rdb::parser::parse_real("123.2"));
+    EXPECT_EQ(std::nullopt, rdb::parser::parse_real(std::string(40, '9') + ".0"));
+
+    EXPECT_EQ(
+        "DELETE FROM t WHERE a < 1.500000;\n"
+        "Int out of range '2147483648' 1:27\n"
+        "Real out of range '-1" + std::string(39, '0') + ".5' 3:25\n",
+        get_parser_result(
+            "INSERT INTO t (a) VALUES (2147483648);\n"
+            "DELETE FROM t WHERE a < 1.5;\n"
+            "DELETE FROM t WHERE a < -1" + std::string(39, '0') + ".5;\n"));
+}
+
+TEST(ParserSuite, OutputBufferTest) {
+    rdb::parser::OutputBuffer out;
+    const int32_t ints[] = {0, -1, 42, INT32_MIN, INT32_MAX};
+    for (const int32_t number : ints) {
+        out.clear();
+        out.append(number);
+        EXPECT_EQ(std::to_string(number), out.view());
+    }
+    // Every exponent, with a few mantissas each, including ones that
+    // round at the sixth decimal.
+    for (uint32_t exponent = 0; exponent < 255; ++exponent) {
+        for (const uint32_t mantissa : {0U, 1U, 0x2aaaaaU, 0x7fffffU}) {
+            for (const uint32_t sign : {0U, 1U}) {
+                const uint32_t bits =
+                    (sign << 31) | (exponent << 23) | mantissa;
+                float number = 0;
+                std::memcpy(&number, &bits, sizeof(number));
+                out.clear();
+                out.append(number);
+                EXPECT_EQ(std::to_string(number), out.view()) << bits;
+            }
+        }
+    }
+    for (const float number : {0.5F, 2.0000005F, 123.199997F, 1e-7F}) {
+        out.clear();
+        out.append(number);
+        EXPECT_EQ(std::to_string(number), out.view());
+    }
+
+    // Statements append to what is already there.
+    rdb::parser::Lexer lexer(
+        "SELECT a FROM t WHERE a > 1.5; DROP TABLE t; "
+        "INSERT INTO t (a, b) VALUES (-1, \"x\"), (2, $1);");
+    rdb::parser::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    ASSERT_EQ(3U, result.script.statements_.size());
+    out.clear();
+    for (const auto& statement : result.script.statements_) {
+        rdb::parser::format_to(out, statement);
+        out.append('\n');
+    }
+    EXPECT_EQ(
+        "SELECT a FROM t WHERE a > 1.500000;\n"
+        "DROP TABLE t;\n"
+        "INSERT INTO t (a, b) VALUES (-1, \"x\"), (2, $1);\n",
+        out.view());
+}
+
+TEST(ParserSuite, InsertColumnsTest) {
+    rdb::parser::Lexer lexer(
+        "INSERT INTO t (a, b, c) VALUES (1, 2, \"x\"), (3, 4.5, \"y\");");
+    rdb::parser::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    ASSERT_EQ(1U, result.script.statements_.size());
+    const auto* insert = std::get_if<rdb::parser::InsertStatement>(
+        &result.script.statements_[0]);
+    ASSERT_NE(nullptr, insert);
+
+    ASSERT_EQ(2U, insert->row_count());
+    ASSERT_EQ(3U, insert->columns().size());
+    const auto& a = insert->columns()[0];
+    const auto& b = insert->columns()[1];
+    const auto& c = insert->columns()[2];
+    EXPECT_EQ(rdb::parser::ColumnDef::Type::Int, a.type_);
+    EXPECT_EQ(rdb::parser::ColumnDef::Type::Real, b.type_);
+    EXPECT_EQ(rdb::parser::ColumnDef::Type::Text, c.type_);
+    EXPECT_EQ(3, a.ints_[1]);
+    EXPECT_EQ(2.0F, b.reals_[0]);
+    EXPECT_EQ("\"y\"", c.texts_[1]);
+    EXPECT_EQ(rdb::parser::Value(4.5F), insert->value(1, 1));
+}
 
+TEST(ParserSuite, ParameterTest) {
+    const auto parser_result = get_parser_result(
+        "SELECT a FROM t WHERE a = ?;\n"
+        "DELETE FROM t WHERE $5 < ?;\n"
+        "INSERT INTO t (a, b) VALUES (?, 1), (2.5, $2);\n"
+        "SELECT a FROM t WHERE a = $0;\n"
+        "SELECT a FROM t WHERE a = $65536;\n"
+        "INSERT INTO t (a, b) VALUES ($1, 1), (\"x\", 2);\n");
+
+    const std::string expected_result =
+        "SELECT a FROM t WHERE a = $1;\n"
+        "DELETE FROM t WHERE $5 < $6;\n"
+        "INSERT INTO t (a, b) VALUES ($7, 1), (2.500000, $2);\n"
+        "INSERT INTO t (a, b) VALUES ($1, 1), (\"x\", 2);\n"
+        "Param out of range '$0' 4:27\n"
+        "Param out of range '$65536' 5:27\n";
     EXPECT_EQ(expected_result, parser_result);
 }
 
+TEST(ParserSuite, PreparedStatementTest) {
+    const auto print = [](const rdb::parser::Script& script) {
+        std::string out;
+        for (const auto& i : script.statements_) {
+            out += rdb::parser::to_string(i) + '\n';
+        }
+        return out;
+    };
+
+    const auto prepared = rdb::parser::prepare_sql(
+        "INSERT INTO t (a, b) VALUES (?, 1), (2.5, $3);\n"
+        "SELECT a FROM t WHERE a > $2;");
+    ASSERT_TRUE(prepared.statement);
+    const auto& statement = *prepared.statement;
+    EXPECT_EQ(3U, statement.parameter_count());
+
+    const auto script =
+        statement.bind({7, std::string_view("x"), rdb::parser::Value(1.5F)});
+    ASSERT_TRUE(script);
+    EXPECT_EQ(0U, script->parameter_count_);
+    EXPECT_EQ(
+        "INSERT INTO t (a, b) VALUES (7.000000, 1.000000), (2.500000, "
+        "1.500000);\n"
+        "SELECT a FROM t WHERE a > \"x\";\n",
+        print(*script));
+    const auto* insert = std::get_if<rdb::parser::InsertStatement>(
+        &script->statements_[0]);
+    ASSERT_NE(nullptr, insert);
+    EXPECT_FALSE(insert->columns()[1].has_parameters());
+    EXPECT_EQ(rdb::parser::ColumnDef::Type::Real, insert->columns()[1].type_);
+
+    // The template is unchanged and can be bound again.
+    EXPECT_EQ(
+        "INSERT INTO t (a, b) VALUES ($1, 1), (2.500000, $3);\n"
+        "SELECT a FROM t WHERE a > $2;\n",
+        print(statement.script()));
+    EXPECT_FALSE(statement.bind({7, 8}));
+    EXPECT_FALSE(statement.bind({std::string_view("x"), 8, 9}));
+
+    const auto bad = rdb::parser::prepare_sql("SELECT a FROM t WHERE a = ;");
+    EXPECT_FALSE(bad.statement);
+    ASSERT_EQ(1U, bad.errors_.size());
+    EXPECT_EQ(
+        "Expected operand, got Semicolon ';' 1:27",
+        bad.errors_[0].to_string());
+}
+
 TEST(ParserSuite, DeleteStatementTest) {
     const auto parser_result = get_parser_result(
         "DELETE FROM t;\n"
@@ -369,3 +709,411 @@ TEST(ParserSuite, DropTableStatementTest) {
         "10:1\n";
     EXPECT_EQ(expected_result, parser_result);
 }
+
+TEST(ParserSuite, CreateIndexStatementTest) {
+    const auto parser_result = get_parser_result(
+        "CREATE INDEX tid ON t (id);\n"
+        "CREATE INDEX tname ON t (name) USING HASH;\n"
+        "CREATE INDEX tx ON t (x) USING BTREE;\n"
+        "CREATE INDEX ON t (id);\n"
+        "CREATE INDEX i t (id);\n"
+        "CREATE INDEX i ON t id;\n"
+        "CREATE INDEX i ON t (id, name);\n"
+        "CREATE INDEX i ON t (id) USING TREE;\n"
+        "CREATE VIEW v;\n");
+
+    const std::string expected_result =
+        "CREATE INDEX tid ON t (id) USING BTREE;\n"
+        "CREATE INDEX tname ON t (name) USING HASH;\n"
+        "CREATE INDEX tx ON t (x) USING BTREE;\n"
+        "Expected Id, got KwOn 'ON' 4:14\n"
+        "Expected KwOn, got Id 't' 5:16\n"
+        "Expected LParen, got Id 'id' 6:21\n"
+        "Expected RParen, got Comma ',' 7:24\n"
+        "Expected HASH or BTREE, got Id 'TREE' 8:32\n"
+        "Expected TABLE or INDEX, got Id 'VIEW' 9:8\n";
+    EXPECT_EQ(expected_result, parser_result);
+}
+
+TEST(ParserSuite, StatementVisitTest) {
+    rdb::parser::Lexer lexer(
+        "CREATE TABLE t (a INT); INSERT INTO t (a) VALUES (1), (2);\n"
+        "SELECT a FROM t; DELETE FROM t WHERE a = 1; DROP TABLE t;\n"
+        "CREATE INDEX ta ON t (a);");
+    rdb::parser::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+    ASSERT_EQ(6U, result.script.statements_.size());
+
+    std::string kinds;
+    size_t rows = 0;
+    for (const auto& statement : result.script.statements_) {
+        kinds += std::visit(
+            rdb::parser::Overloaded{
+                [](const rdb::parser::CreateTableStatement&) { return 'C'; },
+                [](const rdb::parser::SelectStatement&) { return 'S'; },
+                [&](const rdb::parser::InsertStatement& insert) {
+                    rows += insert.row_count();
+                    return 'I';
+                },
+                [](const rdb::parser::DeleteStatement&) { return 'D'; },
+                [](const rdb::parser::DropTableStatement&) { return 'X'; },
+                [](const rdb::parser::CreateIndexStatement&) { return 'N'; },
+            },
+            statement);
+    }
+    EXPECT_EQ("CISDXN", kinds);
+    EXPECT_EQ(2U, rows);
+    EXPECT_EQ(2U, result.script.statements_[1].index());
+}
+
+TEST(ParserSuite, DiagnosticTest) {
+    rdb::parser::Lexer lexer(
+        "SELECT a FROM t WHERE a ; SELECT b FROM t;\n"
+        "DROP TABLE;");
+    rdb::parser::Parser parser(lexer);
+    const auto result = parser.parse_sql_script();
+
+    ASSERT_EQ(1U, result.script.statements_.size());
+    EXPECT_EQ(
+        "SELECT b FROM t;",
+        rdb::parser::to_string(result.script.statements_[0]));
+
+    ASSERT_EQ(2U, result.errors_.size());
+    const auto& error = result.errors_[0];
+    EXPECT_EQ(rdb::parser::Diagnostic::Kind::UnexpectedToken, error.kind_);
+    EXPECT_TRUE(error.expected_.contains(rdb::parser::Token::Kind::Eq));
+    EXPECT_FALSE(error.expected_.contains(rdb::parser::Token::Kind::Id));
+    EXPECT_EQ(rdb::parser::Token::Kind::Semicolon, error.got_);
+    EXPECT_EQ(24U, error.location_.offset_);
+    EXPECT_EQ("Expected opration, got Semicolon ';' 1:25", error.to_string());
+    EXPECT_EQ(
+        "Expected Id, got Semicolon ';' 2:11", result.errors_[1].to_string());
+}
+
+TEST(ParserSuite, ParallelParseTest) {
+    std::string input;
+    const std::string statements[] = {
+        "CREATE TABLE t (a INT, b TEXT);\n",
+        "INSERT INTO t (a, b) VALUES (1, \"x;y\");\n",
+        "SELECT a b FROM t WHERE b = \"; DROP TABLE t;\";\n",
+        "INSERT INTO t (a, b) VALUES (2, \"open;\n",
+        "DELETE FROM t WHERE a < 3; DROP TABLE t;\n",
+        "SELECT FROM t;\n",
+    };
+    for (size_t i = 0; i < 60; ++i) {
+        input += statements[i % std::size(statements)];
+    }
+
+    const auto print = [](const rdb::parser::Parser::Result& result) {
+        std::stringstream out;
+        for (const auto& i : result.script.statements_) {
+            out << rdb::parser::to_string(i) << '\n';
+        }
+        for (const auto& i : result.errors_) {
+            out << i << '\n';
+        }
+        return out.str();
+    };
+
+    rdb::parser::Lexer lexer(input);
+    rdb::parser::Parser parser(lexer);
+    const auto expected_result = print(parser.parse_sql_script());
+
+    const size_t min_chunk_size = 16;
+    for (const size_t n_threads : {1, 3, 8}) {
+        EXPECT_EQ(
+            expected_result,
+            print(rdb::parser::parse_sql_script_parallel(
+                input, n_threads, min_chunk_size)));
+    }
+    EXPECT_EQ(
+        expected_result,
+        print(rdb::parser::parse_sql_script_parallel(input, 4)));
+
+    // `?` is numbered across chunks, after `$N` too. A syntax error hides
+    // the `?` after it, so the chunks that follow must not count it.
+    const std::string parameter_statements[] = {
+        "SELECT a FROM t WHERE a = ?;\n",
+        "INSERT INTO t (a, b) VALUES (?, ?), ($3, ?);\n",
+        "SELECT a FROM t WHERE $7 < a;\n",
+        "DELETE FROM t WHERE a ?;\n",
+    };
+    for (const size_t kinds : {1, 3, 4}) {
+        std::string parameters;
+        for (size_t i = 0; i < 600; ++i) {
+            parameters += parameter_statements[i % kinds];
+        }
+        rdb::parser::Lexer parameter_lexer(parameters);
+        rdb::parser::Parser parameter_parser(parameter_lexer);
+        const auto expected = parameter_parser.parse_sql_script();
+        for (const size_t n_threads : {1, 4}) {
+            const auto parallel = rdb::parser::parse_sql_script_parallel(
+                parameters, n_threads, min_chunk_size);
+            EXPECT_EQ(print(expected), print(parallel));
+            EXPECT_EQ(
+                expected.script.parameter_count_,
+                parallel.script.parameter_count_);
+        }
+        if (kinds == 1) {
+            EXPECT_EQ(600U, expected.script.parameter_count_);
+        }
+    }
+}
+
+TEST(ParserSuite, ScriptSourceTest) {
+    const std::string path = testing::TempDir() + "librdb_script_source.sql";
+    {
+        std::ofstream file(path);
+        file << "DROP TABLE t;\nDROP TABLE;\nSELECT a FROM t WHERE a = 12";
+    }
+
+    rdb::parser::Parser::Result result;
+    {
+        auto source = std::make_shared<const rdb::parser::ScriptSource>(path);
+        rdb::parser::Lexer lexer(source);
+        rdb::parser::Parser parser(lexer);
+        result = parser.parse_sql_script();
+    }
+    std::remove(path.c_str());
+
+    ASSERT_EQ(1U, result.script.statements_.size());
+    EXPECT_EQ(
+        "DROP TABLE t;", rdb::parser::to_string(result.script.statements_[0]));
+    ASSERT_EQ(2U, result.errors_.size());
+    EXPECT_EQ(
+        "Expected Id, got Semicolon ';' 2:11", result.errors_[0].to_string());
+    EXPECT_EQ(
+        "Expected Semicolon, got Eof '<EOF>' 3:29",
+        result.errors_[1].to_string());
+
+    EXPECT_THROW(rdb::parser::ScriptSource{path}, std::system_error);
+}
+
+TEST(ParserSuite, ScriptSourceFifoTest) {
+    const std::string path = testing::TempDir() + "librdb_script_fifo";
+    std::remove(path.c_str());
+    ASSERT_EQ(0, mkfifo(path.c_str(), 0600));
+    std::string script;
+    for (int i = 0; i < 10000; ++i) {
+        script += "SELECT a FROM t WHERE a = " + std::to_string(i) + ";\n";
+    }
+    // A reader that stops early fails the test instead of killing it.
+    std::signal(SIGPIPE, SIG_IGN);
+    // Opening blocks until both ends are open.
+    std::thread writer([&] { std::ofstream(path) << script; });
+
+    rdb::parser::Parser::Result result;
+    {
+        auto source = std::make_shared<const rdb::parser::ScriptSource>(path);
+        EXPECT_TRUE(script == source->text());
+        rdb::parser::Lexer lexer(source);
+        rdb::parser::Parser parser(lexer);
+        result = parser.parse_sql_script();
+    }
+    writer.join();
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(result.errors_.empty());
+    ASSERT_EQ(10000U, result.script.statements_.size());
+    EXPECT_EQ(
+        "SELECT a FROM t WHERE a = 9999;",
+        rdb::parser::to_string(result.script.statements_.back()));
+
+    // A regular file that reports a size of 0.
+    EXPECT_FALSE(rdb::parser::ScriptSource("/proc/self/status").text().empty());
+}
+
+TEST(ParserSuite, BinaryScriptTest) {
+    const std::string input =
+        "CREATE TABLE t (a INT, b REAL, c TEXT);\n"
+        "SELECT a c FROM t WHERE a <= $2;\n"
+        "SELECT a FROM t;\n"
+        "INSERT INTO t (a, b, c) VALUES (1, 2, \"x\"), (3, 4.5, \"x\");\n"
+        "INSERT INTO t (a, c) VALUES (?, \"y\"), (5, ?);\n"
+        "DELETE FROM t WHERE \"x\" != c;\n"
+        "DROP TABLE t;\n"
+        "CREATE INDEX ta ON t (a) USING HASH;\n";
+    rdb::parser::Lexer lexer(input);
+    rdb::parser::Parser parser(lexer);
+    const auto parsed = parser.parse_sql_script();
+    ASSERT_TRUE(parsed.errors_.empty());
+    const auto print = [](const rdb::parser::Script& script) {
+        std::string out;
+        for (const auto& i : script.statements_) {
+            out += rdb::parser::to_string(i) + '\n';
+        }
+        return out;
+    };
+
+    const auto buffer = rdb::parser::ScriptSource::from_text(
+        rdb::parser::write_binary_script(parsed.script));
+    const auto script = rdb::parser::read_binary_script(buffer);
+    ASSERT_TRUE(script);
+    EXPECT_EQ(print(parsed.script), print(*script));
+    EXPECT_EQ(parsed.script.parameter_count_, script->parameter_count_);
+
+    // Payload is read in place, and each string is stored once.
+    const auto text = buffer->text();
+    const auto in_buffer = [&](const void* data) {
+        const auto* byte = static_cast<const char*>(data);
+        return (byte >= text.data()) && (byte < text.data() + text.size());
+    };
+    const auto* insert = std::get_if<rdb::parser::InsertStatement>(
+        &script->statements_[3]);
+    ASSERT_NE(nullptr, insert);
+    EXPECT_TRUE(in_buffer(insert->table_name().data()));
+    EXPECT_EQ(
+        insert->columns()[2].texts_[0].data(),
+        insert->columns()[2].texts_[1].data());
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    EXPECT_TRUE(in_buffer(insert->columns()[0].ints_.begin()));
+    EXPECT_TRUE(in_buffer(insert->columns()[1].reals_.begin()));
+#endif
+
+    // Every truncation and a changed version are rejected.
+    for (size_t size = 0; size < text.size(); ++size) {
+        EXPECT_FALSE(rdb::parser::read_binary_script(
+            rdb::parser::ScriptSource::from_text(
+                std::string(text.substr(0, size)))))
+            << size;
+    }
+    std::string other_version(text);
+    other_version[4] = char(rdb::parser::binary_script_version + 1);
+    EXPECT_FALSE(rdb::parser::read_binary_script(
+        rdb::parser::ScriptSource::from_text(other_version)));
+    // A string pointing past the table.
+    std::string bad_string(text);
+    bad_string[28] = 0x7f;
+    EXPECT_FALSE(rdb::parser::read_binary_script(
+        rdb::parser::ScriptSource::from_text(bad_string)));
+}
+
+TEST(ParserSuite, StreamParseTest) {
+    const std::string input =
+        "CREATE TABLE t (a INT, b TEXT);\n"
+        "INSERT INTO t (a, b) VALUES (1, \"x;y\");\n"
+        "SELECT a b FROM t WHERE b = \"; DROP TABLE t;\";\n"
+        "INSERT INTO t (a, b) VALUES (2, \"open;\n"
+        "DELETE FROM t WHERE a < 3; DROP TABLE t;\n"
+        "SELECT FROM t;\n"
+        "SELECT a FROM t WHERE a = 12";
+
+    std::stringstream expected;
+    {
+        rdb::parser::Lexer lexer(input);
+        rdb::parser::Parser parser(lexer);
+        const auto result = parser.parse_sql_script();
+        for (const auto& i : result.script.statements_) {
+            expected << rdb::parser::to_string(i) << '\n';
+        }
+        for (const auto& i : result.errors_) {
+            expected << i << '\n';
+        }
+    }
+
+    for (const size_t chunk_size : {1, 2, 7, 64, 4096}) {
+        // Statements and errors of a batch come in the same callback, so
+        // both are collected separately and compared in order.
+        std::stringstream statements;
+        std::stringstream errors;
+        std::vector<rdb::parser::Parser::Result> results;
+        std::istringstream stream(input);
+        rdb::parser::parse_sql_stream(
+            stream,
+            [&](rdb::parser::Parser::Result result) {
+                for (const auto& i : result.script.statements_) {
+                    statements << rdb::parser::to_string(i) << '\n';
+                }
+                results.push_back(std::move(result));
+            },
+            chunk_size);
+        for (const auto& result : results) {
+            for (const auto& i : result.errors_) {
+                errors << i << '\n';
+            }
+        }
+        EXPECT_EQ(expected.str(), statements.str() + errors.str())
+            << "chunk_size = " << chunk_size;
+    }
+}
+
+TEST(ParserSuite, StatementCacheTest) {
+    const auto print = [](const rdb::parser::Parser::Result& result) {
+        std::stringstream out;
+        for (const auto& i : result.script.statements_) {
+            out << rdb::parser::to_string(i) << '\n';
+        }
+        for (const auto& i : result.errors_) {
+            out << i << '\n';
+        }
+        return out.str();
+    };
+    const auto parse = [&](std::string_view input) {
+        rdb::parser::Lexer lexer(input);
+        rdb::parser::Parser parser(lexer);
+        return print(parser.parse_sql_script());
+    };
+
+    const std::string inputs[] = {
+        "SELECT a FROM t WHERE a < 1;",
+        "SELECT a FROM t WHERE a < 22;",
+        "SELECT a FROM t WHERE a < 2147483648;",
+        "SELECT a FROM t WHERE 3 < a;",
+        "SELECT a FROM t WHERE a < 2.5;",
+        "SELECT a FROM u WHERE a < 2;",
+        "INSERT INTO t (a, b) VALUES (1, \"x\"), (2.5, \"y\");",
+        "INSERT INTO t (a, b) VALUES (3, \"z\"), (4.25, \"w\");",
+        "DELETE FROM t WHERE a = \"s\"; DROP TABLE t;",
+        "DELETE FROM t WHERE a = \"q\"; DROP TABLE t;",
+        "CREATE TABLE t (a INT, b TEXT);",
+        "CREATE TABLE t (a INT, b TEXT);",
+        "SELECT a FROM t WHERE a <;",
+        "SELECT a FROM t WHERE a <;",
+    };
+
+    EXPECT_EQ(
+        rdb::parser::fingerprint(inputs[0]),
+        rdb::parser::fingerprint(inputs[1]));
+    EXPECT_NE(
+        rdb::parser::fingerprint(inputs[1]),
+        rdb::parser::fingerprint(inputs[4]));
+    EXPECT_NE(
+        rdb::parser::fingerprint(inputs[1]),
+        rdb::parser::fingerprint(inputs[5]));
+    EXPECT_NE(
+        rdb::parser::fingerprint("SELECT a FROM t WHERE a < $1;"),
+        rdb::parser::fingerprint("SELECT a FROM t WHERE a < $2;"));
+
+    rdb::parser::StatementCache cache(4);
+    for (const auto& input : inputs) {
+        EXPECT_EQ(parse(input), print(cache.parse(input))) << input;
+    }
+    // Hits: 22, the overflowing literal (which is then parsed to report
+    // it) and the second INSERT, DELETE/DROP and CREATE statement.
+    // Statements with errors are never cached.
+    EXPECT_EQ(5U, cache.hits());
+    EXPECT_EQ(9U, cache.misses());
+    EXPECT_EQ(4U, cache.size());
+
+    // The least recently used shapes were evicted.
+    EXPECT_EQ(parse(inputs[3]), print(cache.parse(inputs[3])));
+    EXPECT_EQ(10U, cache.misses());
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread] {
+            for (int i = 0; i < 200; ++i) {
+                const std::string input = "SELECT a FROM t WHERE a = " +
+                    std::to_string(thread * 1000 + i) + ";";
+                const auto result = cache.parse(input);
+                ASSERT_EQ(1U, result.script.statements_.size());
+                ASSERT_EQ(
+                    input,
+                    rdb::parser::to_string(result.script.statements_[0]));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
@@ -42,6 +42,16 @@ std::string_view kind_to_str(const Token::Kind& token_kind) {
             return "KwReal";
         case Token::Kind::KwText:
             return "KwText";
+        case Token::Kind::KwIndex:
+            return "KwIndex";
+        case Token::Kind::KwOn:
+            return "KwOn";
+        case Token::Kind::KwUsing:
+            return "KwUsing";
+        case Token::Kind::KwHash:
+            return "KwHash";
+        case Token::Kind::KwBtree:
+            return "KwBtree";
         case Token::Kind::Semicolon:
             return "Semicolon";
         case Token::Kind::Comma:
@@ -70,6 +80,8 @@ std::string_view kind_to_str(const Token::Kind& token_kind) {
             return "Real";
         case Token::Kind::Text:
             return "Text";
+        case Token::Kind::Param:
+            return "Param";
         case Token::Kind::Eof:
             return "Eof";
         case Token::Kind::Unknown:
@@ -80,7 +92,7 @@ std::string_view kind_to_str(const Token::Kind& token_kind) {
 
 std::ostream& operator<<(std::ostream& os, const Token& token) {
     os << kind_to_str(token.type()) << " '" << token.lexeme() << "' "
-       << "Loc=" << token.location().rows_ << ":" << token.location().cols_;
+       << "Loc=" << token.location().rows() << ":" << token.location().cols();
     return os;
 }
 
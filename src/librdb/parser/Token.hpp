@@ -2,6 +2,7 @@
 
 #include <librdb/parser/Location.hpp>
 
+#include <cstdint>
 #include <ostream>
 #include <string_view>
 
@@ -9,7 +10,7 @@ namespace rdb::parser {
 
 class Token {
    public:
-    enum class Kind {
+    enum class Kind : uint8_t {
         KwSelect,
         KwFrom,
         KwDrop,
@@ -23,6 +24,11 @@ class Token {
         KwInt,
         KwReal,
         KwText,
+        KwIndex,
+        KwOn,
+        KwUsing,
+        KwHash,
+        KwBtree,
         Semicolon,
         Comma,
         LParen,
@@ -37,6 +43,8 @@ class Token {
         Int,
         Real,
         Text,
+        // `?` or `$N`.
+        Param,
         Eof,
         Unknown,
     };
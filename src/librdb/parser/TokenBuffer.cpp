@@ -0,0 +1,34 @@
+#include <librdb/parser/TokenBuffer.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace rdb::parser {
+
+void TokenBuffer::reserve(size_t size) {
+    kinds_.reserve(size);
+    offsets_.reserve(size);
+    lengths_.reserve(size);
+}
+
+void TokenBuffer::push_back(const Token& token) {
+    const size_t offset = token.location().offset_;
+    const size_t length =
+        token.type() == Token::Kind::Eof ? 0 : token.lexeme().size();
+    assert(length <= std::numeric_limits<uint32_t>::max());
+    kinds_.push_back(static_cast<uint8_t>(token.type()));
+    offsets_.push_back(offset);
+    lengths_.push_back(static_cast<uint32_t>(length));
+}
+
+std::string_view TokenBuffer::lexeme(size_t index) const {
+    if (kind(index) == Token::Kind::Eof) {
+        return "<EOF>";
+    }
+    return input_.substr(offsets_[index], lengths_[index]);
+}
+
+}  // namespace rdb::parser
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <librdb/parser/Location.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Token.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::parser {
+
+// Tokens of a whole input stored as parallel arrays of kinds, offsets and
+// lengths. Always ends with an Eof token. Lexemes point into the input,
+// which must outlive the buffer unless `source` owns it.
+class TokenBuffer {
+   public:
+    TokenBuffer(
+        std::string_view input,
+        std::shared_ptr<const LineIndex> line_index,
+        std::shared_ptr<const ScriptSource> source = nullptr)
+        : input_(input),
+          line_index_(std::move(line_index)),
+          source_(std::move(source)) {}
+
+    void reserve(size_t size);
+    void push_back(const Token& token);
+
+    size_t size() const { return kinds_.size(); }
+
+    // Number of tokens of `kind`.
+    size_t count(Token::Kind kind) const {
+        return std::count(
+            kinds_.begin(), kinds_.end(), static_cast<uint8_t>(kind));
+    }
+
+    Token::Kind kind(size_t index) const {
+        return static_cast<Token::Kind>(kinds_[index]);
+    }
+
+    size_t offset(size_t index) const { return offsets_[index]; }
+
+    std::string_view lexeme(size_t index) const;
+
+    Token token(size_t index) const {
+        return Token(
+            kind(index),
+            lexeme(index),
+            Location(offset(index), line_index_.get()));
+    }
+
+    const std::shared_ptr<const LineIndex>& line_index() const {
+        return line_index_;
+    }
+
+    const std::shared_ptr<const ScriptSource>& source() const {
+        return source_;
+    }
+
+   private:
+    std::string_view input_;
+    std::shared_ptr<const LineIndex> line_index_;
+    std::shared_ptr<const ScriptSource> source_;
+    std::vector<uint8_t> kinds_;
+    std::vector<size_t> offsets_;
+    std::vector<uint32_t> lengths_;
+};
+
+}  // namespace rdb::parser
@@ -0,0 +1,84 @@
+#include <librdb/storage/Checksum.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define RDB_CHECKSUM_X86 1
+#include <immintrin.h>
+#endif
+
+namespace rdb::storage {
+
+namespace {
+
+using Crc32cFunction = uint32_t (*)(const unsigned char*, size_t, uint32_t);
+
+// Reflected CRC-32C polynomial.
+constexpr uint32_t polynomial = 0x82F63B78;
+
+constexpr std::array<uint32_t, 256> make_crc_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> crc_table = make_crc_table();
+
+uint32_t crc32c_scalar(const unsigned char* data, size_t size, uint32_t crc) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef RDB_CHECKSUM_X86
+
+__attribute__((target("sse4.2"))) uint32_t crc32c_sse42(
+    const unsigned char* data,
+    size_t size,
+    uint32_t crc) {
+    uint64_t crc64 = crc;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += sizeof(word);
+    }
+    auto crc32 = static_cast<uint32_t>(crc64);
+    for (; size > 0; --size) {
+        crc32 = _mm_crc32_u8(crc32, *data++);
+    }
+    return crc32;
+}
+
+#endif  // RDB_CHECKSUM_X86
+
+Crc32cFunction select_crc32c() {
+#ifdef RDB_CHECKSUM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2") != 0) {
+        return crc32c_sse42;
+    }
+#endif
+    return crc32c_scalar;
+}
+
+const Crc32cFunction crc32c_function = select_crc32c();
+
+}  // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+    return ~crc32c_function(
+        static_cast<const unsigned char*>(data), size, ~crc);
+}
+
+}  // namespace rdb::storage
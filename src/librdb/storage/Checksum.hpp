@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rdb::storage {
+
+// CRC-32C (Castagnoli) of `size` bytes at `data`, continuing from `crc`.
+// The SSE4.2 crc32 instruction is used when the CPU has it.
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace rdb::storage
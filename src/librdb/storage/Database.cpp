@@ -0,0 +1,417 @@
+#include <librdb/storage/Database.hpp>
+
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/Engine.hpp>
+#include <librdb/engine/Index.hpp>
+#include <librdb/engine/Table.hpp>
+#include <librdb/parser/BinaryScript.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/ScriptSource.hpp>
+#include <librdb/parser/Statements.hpp>
+#include <librdb/storage/Encoding.hpp>
+#include <librdb/storage/File.hpp>
+#include <librdb/storage/PageFile.hpp>
+#include <librdb/storage/Wal.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rdb::storage {
+
+// The catalog of a checkpoint is a sequence of little-endian words:
+//
+//   table count, then per table
+//     name, row count, column count, then per column
+//       name, type, chain of the values: INT and REAL as arrays in host
+//       byte order, TEXT as an array of u32 lengths followed by a chain
+//       of the characters
+//     index count, then per index
+//       name, column, method
+//
+// Strings are a u32 size followed by the bytes.
+
+namespace {
+
+using Type = parser::ColumnDef::Type;
+
+std::string file_in(const std::string& directory, const char* name) {
+    std::filesystem::create_directories(directory);
+    return directory + "/" + name;
+}
+
+std::runtime_error corrupt_catalog() {
+    return std::runtime_error("corrupt catalog in checkpoint");
+}
+
+// Calls `append` on each of the `row_count` values of type T in `chain`.
+template <typename T, typename Append>
+void scan_array(
+    const PageFile& pages,
+    const Chain& chain,
+    size_t row_count,
+    const Append& append) {
+    // No value straddles two pages.
+    static_assert(PageFile::payload_size % sizeof(T) == 0);
+    if (chain.size_ != row_count * sizeof(T)) {
+        throw corrupt_catalog();
+    }
+    pages.scan(chain, [&](const char* data, size_t size) {
+        for (size_t offset = 0; offset < size; offset += sizeof(T)) {
+            T value;
+            std::memcpy(&value, data + offset, sizeof(T));
+            append(value);
+        }
+    });
+}
+
+// The characters of a TEXT column, split into values by `lengths`.
+void scan_text(
+    const PageFile& pages,
+    const Chain& chain,
+    const std::vector<uint32_t>& lengths,
+    engine::Column& column) {
+    size_t row = 0;
+    // The start of a value continued on the next page.
+    std::string partial;
+    const auto split = [&](std::string_view data) {
+        for (; row < lengths.size(); ++row) {
+            const size_t missing = lengths[row] - partial.size();
+            if (missing > data.size()) {
+                partial += data;
+                return;
+            }
+            if (partial.empty()) {
+                column.append(data.substr(0, missing));
+            } else {
+                partial += data.substr(0, missing);
+                column.append(std::string_view(partial));
+                partial.clear();
+            }
+            data.remove_prefix(missing);
+        }
+        if (!data.empty()) {
+            throw corrupt_catalog();
+        }
+    };
+    pages.scan(chain, [&](const char* data, size_t size) {
+        split(std::string_view(data, size));
+    });
+    // Empty values after the last page.
+    split({});
+    if (row != lengths.size()) {
+        throw corrupt_catalog();
+    }
+}
+
+}  // namespace
+
+Database::Database(const std::string& directory)
+    : pages_(file_in(directory, "tables.rdb")),
+      wal_(file_in(directory, "wal.log")) {
+    sync_directory(directory);
+    load();
+    collector_ = std::thread([this] { collect(); });
+}
+
+Database::~Database() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    collect_.notify_one();
+    collector_.join();
+}
+
+std::vector<engine::StatementResult> Database::execute(
+    const parser::Script& script) {
+    const auto& statements = script.statements_;
+    if (std::all_of(
+            statements.begin(), statements.end(), [](const auto& statement) {
+                return std::holds_alternative<parser::SelectStatement>(
+                    statement);
+            })) {
+        return engine_.execute(script);
+    }
+
+    std::vector<engine::StatementResult> results;
+    uint64_t lsn = 0;
+    bool vacuum = false;
+    {
+        std::lock_guard lock(mutex_);
+        results = engine_.execute(script);
+        lsn = log(script, results);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto* remove =
+                std::get_if<parser::DeleteStatement>(&statements[i]);
+            if ((remove == nullptr) || (results[i].rows_affected_ == 0)) {
+                continue;
+            }
+            const auto table = engine_.catalog().find_table(
+                remove->table_name());
+            if (table && table->dead_fraction_at_least(vacuum_fraction)) {
+                vacuum = true;
+            }
+        }
+        if (vacuum) {
+            ++vacuums_requested_;
+        }
+    }
+    if (vacuum) {
+        collect_.notify_one();
+    }
+    if (lsn != 0) {
+        wal_.commit(lsn);
+    }
+    return results;
+}
+
+engine::StatementResult Database::execute(const parser::Statement& statement) {
+    parser::Script script;
+    script.statements_.push_back(statement);
+    return std::move(execute(script).front());
+}
+
+void Database::wait_for_collector() {
+    std::unique_lock lock(mutex_);
+    const uint64_t requested = vacuums_requested_;
+    collected_.wait(lock, [&] { return vacuums_done_ >= requested; });
+}
+
+CheckpointStats Database::checkpoint() {
+    std::lock_guard lock(mutex_);
+    std::lock_guard vacuum_lock(vacuum_mutex_);
+    engine_.vacuum();
+    std::string catalog;
+    std::map<std::string, std::vector<uint32_t>, std::less<>> chains;
+    const auto tables = engine_.catalog().tables();
+    store_u32(catalog, static_cast<uint32_t>(tables.size()));
+    for (const auto& table : tables) {
+        const auto old = chains_.find(table->name());
+        size_t old_chain = 0;
+        std::vector<uint32_t>& table_chains = chains[table->name()];
+        // Stores a chain whose first `unchanged` bytes are those of the
+        // same chain in the current checkpoint, if the table has one.
+        const auto write = [&](const void* data,
+                               uint64_t size,
+                               uint64_t unchanged) {
+            const Chain* previous = nullptr;
+            if ((old != chains_.end()) && (old_chain < old->second.size())) {
+                previous = &pages_.chains()[old->second[old_chain]];
+            }
+            ++old_chain;
+            const uint32_t chain = pages_.write(
+                static_cast<const char*>(data), size, previous, unchanged);
+            table_chains.push_back(chain);
+            store_u32(catalog, chain);
+        };
+
+        const size_t unchanged = table->unchanged_rows();
+        store_string(catalog, table->name());
+        store_u64(catalog, table->row_count());
+        store_u32(catalog, static_cast<uint32_t>(table->schema().size()));
+        for (size_t i = 0; i < table->schema().size(); ++i) {
+            const engine::Column& column = table->column(i);
+            store_string(catalog, table->schema()[i].name_);
+            store_u32(catalog, static_cast<uint32_t>(column.type()));
+            switch (column.type()) {
+                case Type::Int:
+                    write(
+                        column.ints().data(),
+                        column.size() * sizeof(int32_t),
+                        unchanged * sizeof(int32_t));
+                    break;
+                case Type::Real:
+                    write(
+                        column.reals().data(),
+                        column.size() * sizeof(float),
+                        unchanged * sizeof(float));
+                    break;
+                case Type::Text: {
+                    std::vector<uint32_t> lengths(column.size());
+                    for (size_t row = 0; row < lengths.size(); ++row) {
+                        lengths[row] = static_cast<uint32_t>(
+                            column.text_offset(row + 1) -
+                            column.text_offset(row));
+                    }
+                    write(
+                        lengths.data(),
+                        lengths.size() * sizeof(uint32_t),
+                        unchanged * sizeof(uint32_t));
+                    write(
+                        column.heap().data(),
+                        column.heap().size(),
+                        column.text_offset(unchanged));
+                    break;
+                }
+            }
+        }
+
+        const auto lock_indexes = table->lock_indexes();
+        store_u32(catalog, static_cast<uint32_t>(table->indexes().size()));
+        for (const engine::Index& index : table->indexes()) {
+            store_string(catalog, index.name());
+            store_u32(catalog, static_cast<uint32_t>(index.column()));
+            store_u32(catalog, static_cast<uint32_t>(index.method()));
+        }
+    }
+
+    // Every statement logged so far has been executed under the lock.
+    const CheckpointStats stats =
+        pages_.checkpoint(wal_.last_lsn(), std::move(catalog));
+    wal_.reset();
+    for (const auto& table : tables) {
+        const auto next = table->next_version();
+        next->mark_unchanged();
+        engine_.catalog().publish(next);
+    }
+    chains_ = std::move(chains);
+    return stats;
+}
+
+void Database::load() {
+    const std::string& catalog = pages_.catalog();
+    if (!catalog.empty()) {
+        Decoder decoder(catalog.data(), catalog.size());
+        std::vector<uint32_t>* table_chains = nullptr;
+        // The next chain of the table being loaded.
+        const auto chain = [&]() -> const Chain& {
+            const uint32_t index = decoder.u32();
+            if (index >= pages_.chains().size()) {
+                throw corrupt_catalog();
+            }
+            table_chains->push_back(index);
+            return pages_.chains()[index];
+        };
+
+        for (uint32_t table_count = decoder.u32(); table_count > 0;
+             --table_count) {
+            std::string name = decoder.string();
+            const uint64_t row_count = decoder.u64();
+            std::vector<engine::ColumnSchema> schema(decoder.u32());
+            std::vector<engine::Column> columns;
+            table_chains = &chains_[name];
+            for (auto& column_schema : schema) {
+                column_schema.name_ = decoder.string();
+                const uint32_t type = decoder.u32();
+                if (type > static_cast<uint32_t>(Type::Text)) {
+                    throw corrupt_catalog();
+                }
+                column_schema.type_ = static_cast<Type>(type);
+                engine::Column& column =
+                    columns.emplace_back(column_schema.type_);
+
+                column.reserve(row_count);
+                const auto append = [&](auto value) { column.append(value); };
+                switch (column_schema.type_) {
+                    case Type::Int:
+                        scan_array<int32_t>(pages_, chain(), row_count, append);
+                        break;
+                    case Type::Real:
+                        scan_array<float>(pages_, chain(), row_count, append);
+                        break;
+                    case Type::Text: {
+                        std::vector<uint32_t> lengths;
+                        lengths.reserve(row_count);
+                        scan_array<uint32_t>(
+                            pages_, chain(), row_count, [&](uint32_t length) {
+                                lengths.push_back(length);
+                            });
+                        scan_text(pages_, chain(), lengths, column);
+                        break;
+                    }
+                }
+            }
+
+            const auto table =
+                std::make_shared<engine::Table>(name, std::move(schema));
+            table->restore(std::move(columns));
+
+            for (uint32_t index_count = decoder.u32(); index_count > 0;
+                 --index_count) {
+                std::string index_name = decoder.string();
+                const uint32_t column = decoder.u32();
+                const uint32_t method = decoder.u32();
+                if ((column >= table->schema().size()) ||
+                    (method > static_cast<uint32_t>(
+                                  engine::Index::Method::BTree))) {
+                    throw corrupt_catalog();
+                }
+                table->create_index(
+                    std::move(index_name),
+                    column,
+                    static_cast<engine::Index::Method>(method));
+            }
+            if (!engine_.catalog().add_table(table)) {
+                throw corrupt_catalog();
+            }
+        }
+        if (!decoder.done()) {
+            throw corrupt_catalog();
+        }
+    }
+
+    wal_.replay(pages_.lsn(), [&](uint64_t /*lsn*/, std::string_view record) {
+        const auto script = parser::read_binary_script(
+            parser::ScriptSource::from_text(std::string(record)));
+        if (!script) {
+            throw std::runtime_error("corrupt record in write-ahead log");
+        }
+        engine_.execute(*script);
+    });
+    engine_.vacuum();
+}
+
+uint64_t Database::log(
+    const parser::Script& script,
+    const std::vector<engine::StatementResult>& results) {
+    parser::Script changes;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const parser::Statement& statement = script.statements_[i];
+        if (!results[i].error_ &&
+            !std::holds_alternative<parser::SelectStatement>(statement)) {
+            changes.statements_.push_back(statement);
+        }
+    }
+    if (changes.statements_.empty()) {
+        return 0;
+    }
+    return wal_.append(parser::write_binary_script(changes));
+}
+
+void Database::collect() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        collect_.wait(lock, [&] {
+            return (vacuums_done_ < vacuums_requested_) || stopping_;
+        });
+        if (stopping_) {
+            return;
+        }
+        // Scripts that ask for a vacuum from here on get another one.
+        const uint64_t requested = vacuums_requested_;
+        lock.unlock();
+        {
+            std::lock_guard vacuum_lock(vacuum_mutex_);
+            engine_.vacuum(vacuum_fraction);
+        }
+        lock.lock();
+        vacuums_done_ = requested;
+        collected_.notify_all();
+    }
+}
+
+}  // namespace rdb::storage
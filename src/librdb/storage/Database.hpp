@@ -0,0 +1,96 @@
+#pragma once
+
+#include <librdb/engine/Catalog.hpp>
+#include <librdb/engine/Engine.hpp>
+#include <librdb/parser/Script.hpp>
+#include <librdb/parser/Statements.hpp>
+#include <librdb/storage/PageFile.hpp>
+#include <librdb/storage/Wal.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rdb::storage {
+
+// An Engine whose tables survive restarts. The directory holds
+//
+//   tables.rdb  the tables as of the last checkpoint, in a PageFile
+//   wal.log     every statement that changed them since, in the Wal
+//
+// Opening loads the checkpoint and replays the log on top of it. Tables
+// stay in memory; checkpoint() writes the rows changed since the previous
+// one and empties the log.
+//
+// execute() may be called from several threads: scripts that change
+// tables run one at a time, but the log is synced outside the lock, so
+// concurrent writers share syncs. Scripts of SELECTs only take no lock and
+// read the tables as they were when each SELECT started. Rows deleted are
+// dropped by a background thread once they make up vacuum_fraction of a
+// table; it copies the table without holding up writers.
+class Database {
+   public:
+    static constexpr double vacuum_fraction = 0.25;
+
+    // Creates the directory if needed. Throws std::system_error on I/O
+    // errors and std::runtime_error if the files are corrupt.
+    explicit Database(const std::string& directory);
+    ~Database();
+
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+
+    // Return once the changes made are durable.
+    std::vector<engine::StatementResult> execute(const parser::Script& script);
+    engine::StatementResult execute(const parser::Statement& statement);
+
+    // Writes no deleted rows: they are dropped first.
+    CheckpointStats checkpoint();
+
+    // Returns once the background vacuum asked for by the scripts that
+    // finished before the call is done.
+    void wait_for_collector();
+
+    const engine::Catalog& catalog() const { return engine_.catalog(); }
+    const Wal& wal() const { return wal_; }
+
+   private:
+    void load();
+    // Logs the statements of `script` that succeeded and changed tables,
+    // as one record. 0 if there are none.
+    uint64_t log(
+        const parser::Script& script,
+        const std::vector<engine::StatementResult>& results);
+    // Body of collector_: vacuums when a script has left enough deleted
+    // rows in a table.
+    void collect();
+
+    // Held by every script that changes tables and by checkpoint().
+    std::mutex mutex_;
+    engine::Engine engine_;
+    PageFile pages_;
+    Wal wal_;
+    // By table: the chains of its columns in the current checkpoint, one
+    // per INT or REAL column and two (lengths, characters) per TEXT one.
+    std::map<std::string, std::vector<uint32_t>, std::less<>> chains_;
+
+    // Held by collector_ while it vacuums and by checkpoint(), which must
+    // not see tables change under it.
+    std::mutex vacuum_mutex_;
+    // Guarded by mutex_: vacuums asked for and done, counted so that
+    // wait_for_collector() knows which it has to wait for.
+    uint64_t vacuums_requested_ = 0;
+    uint64_t vacuums_done_ = 0;
+    bool stopping_ = false;
+    std::condition_variable collect_;
+    std::condition_variable collected_;
+    std::thread collector_;
+};
+
+}  // namespace rdb::storage
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace rdb::storage {
+
+// Little-endian integers in on-disk structures.
+
+inline void store_u32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+inline void store_u64(std::string& out, uint64_t value) {
+    store_u32(out, static_cast<uint32_t>(value));
+    store_u32(out, static_cast<uint32_t>(value >> 32));
+}
+
+inline void store_string(std::string& out, const std::string& value) {
+    store_u32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+inline uint32_t load_u32(const char* data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+        (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+inline uint64_t load_u64(const char* data) {
+    return uint64_t(load_u32(data)) | (uint64_t(load_u32(data + 4)) << 32);
+}
+
+// Reads the fields of a buffer front to back, throwing std::runtime_error
+// instead of reading past its end.
+class Decoder {
+   public:
+    Decoder(const char* data, size_t size) : data_(data), end_(data + size) {}
+
+    uint32_t u32() { return load_u32(take(sizeof(uint32_t))); }
+    uint64_t u64() { return load_u64(take(sizeof(uint64_t))); }
+    std::string string() {
+        const uint32_t size = u32();
+        return std::string(take(size), size);
+    }
+
+    bool done() const { return data_ == end_; }
+
+   private:
+    const char* take(size_t size) {
+        if (size > static_cast<size_t>(end_ - data_)) {
+            throw std::runtime_error("truncated storage record");
+        }
+        const char* field = data_;
+        data_ += size;
+        return field;
+    }
+
+    const char* data_;
+    const char* end_;
+};
+
+}  // namespace rdb::storage
@@ -0,0 +1,112 @@
+#include <librdb/storage/File.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rdb::storage {
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+File::File(std::string path) : path_(std::move(path)) {
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw_errno("open " + path_);
+    }
+}
+
+File::~File() {
+    close(fd_);
+}
+
+uint64_t File::size() const {
+    struct stat info {};
+    if (fstat(fd_, &info) != 0) {
+        throw_errno("stat " + path_);
+    }
+    return static_cast<uint64_t>(info.st_size);
+}
+
+bool File::read_at(uint64_t offset, void* data, size_t size) const {
+    auto* out = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t n = pread(fd_, out, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("read " + path_);
+        }
+        if (n == 0) {
+            return false;
+        }
+        out += n;
+        offset += static_cast<uint64_t>(n);
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void File::write_at(uint64_t offset, const void* data, size_t size) {
+    const auto* in = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = pwrite(fd_, in, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("write " + path_);
+        }
+        in += n;
+        offset += static_cast<uint64_t>(n);
+        size -= static_cast<size_t>(n);
+    }
+}
+
+void File::truncate(uint64_t size) {
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        throw_errno("truncate " + path_);
+    }
+}
+
+void File::prefetch(uint64_t offset, uint64_t size) const {
+    // Only a hint: a failure just means no read-ahead.
+    posix_fadvise(
+        fd_,
+        static_cast<off_t>(offset),
+        static_cast<off_t>(size),
+        POSIX_FADV_WILLNEED);
+}
+
+void File::sync() {
+    if (fdatasync(fd_) != 0) {
+        throw_errno("sync " + path_);
+    }
+}
+
+void sync_directory(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("open " + path);
+    }
+    const int result = fsync(fd);
+    close(fd);
+    if (result != 0) {
+        throw_errno("sync " + path);
+    }
+}
+
+}  // namespace rdb::storage
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rdb::storage {
+
+// A file opened for reading and writing at explicit offsets. Every I/O
+// error throws std::system_error naming the file.
+class File {
+   public:
+    // Creates `path` if it does not exist.
+    explicit File(std::string path);
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+    File(File&&) = delete;
+    File& operator=(File&&) = delete;
+    ~File();
+
+    const std::string& path() const { return path_; }
+    uint64_t size() const;
+
+    // false if the file ends before `size` bytes were read.
+    bool read_at(uint64_t offset, void* data, size_t size) const;
+    void write_at(uint64_t offset, const void* data, size_t size);
+    void truncate(uint64_t size);
+    // Asks the kernel to start reading the range in the background.
+    void prefetch(uint64_t offset, uint64_t size) const;
+    // Returns once everything written is on stable storage.
+    void sync();
+
+   private:
+    std::string path_;
+    int fd_;
+};
+
+// Makes the creation of files in `path` durable.
+void sync_directory(const std::string& path);
+
+}  // namespace rdb::storage
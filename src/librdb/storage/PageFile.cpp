@@ -0,0 +1,367 @@
+#include <librdb/storage/PageFile.hpp>
+
+#include <librdb/storage/Checksum.hpp>
+#include <librdb/storage/Encoding.hpp>
+#include <librdb/storage/File.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdb::storage {
+
+namespace {
+
+constexpr std::string_view magic = "RDBP";
+constexpr uint32_t version = 1;
+
+constexpr size_t header_size = page_size - PageFile::payload_size;
+constexpr uint32_t no_page = UINT32_MAX;
+// At most this many pages are buffered before they are written.
+constexpr size_t max_pending_pages = 64;
+// How far ahead of a scan the kernel is asked to read.
+constexpr size_t prefetch_pages = 32;
+
+// Page kinds.
+constexpr uint32_t root_page = 1;
+constexpr uint32_t meta_page = 2;
+constexpr uint32_t data_page = 3;
+
+uint32_t used_bytes(const char* page) {
+    return load_u32(page + 8);
+}
+
+bool is_intact(const char* page, uint32_t kind) {
+    const uint32_t crc =
+        crc32c(page + sizeof(uint32_t), page_size - sizeof(uint32_t));
+    return (load_u32(page) == crc) && (load_u32(page + 4) == kind) &&
+        (used_bytes(page) <= PageFile::payload_size);
+}
+
+uint32_t pages_for(uint64_t size) {
+    return static_cast<uint32_t>(
+        (size + PageFile::payload_size - 1) / PageFile::payload_size);
+}
+
+}  // namespace
+
+PageFile::PageFile(std::string path) : file_(std::move(path)) {
+    if (file_.size() == 0) {
+        checkpoint(0, {});
+        return;
+    }
+    Root roots[2];
+    const bool valid[2] = {read_root(0, roots[0]), read_root(1, roots[1])};
+    if (!valid[0] && !valid[1]) {
+        throw std::runtime_error(file_.path() + ": no valid root page");
+    }
+    const bool second = valid[1] &&
+        (!valid[0] || (roots[1].sequence_ > roots[0].sequence_));
+    load(roots[second ? 1 : 0]);
+}
+
+std::string PageFile::read(const Chain& chain) const {
+    std::string data;
+    data.reserve(chain.size_);
+    scan(chain, [&](const char* payload, size_t size) {
+        data.append(payload, size);
+    });
+    return data;
+}
+
+void PageFile::scan(const Chain& chain, const Consume& consume) const {
+    char buffer[page_size];
+    uint64_t remaining = chain.size_;
+    for (size_t i = 0; i < chain.pages_.size(); ++i) {
+        if (i % prefetch_pages == 0) {
+            // The window after the one being read, and at first that one
+            // too.
+            prefetch(chain, i == 0 ? 0 : i + prefetch_pages);
+        }
+        const uint32_t page = chain.pages_[i];
+        if (!file_.read_at(uint64_t(page) * page_size, buffer, page_size) ||
+            !is_intact(buffer, data_page)) {
+            throw corrupt_page(page);
+        }
+        const uint32_t used = used_bytes(buffer);
+        if (used != std::min<uint64_t>(payload_size, remaining)) {
+            throw corrupt_page(page);
+        }
+        consume(buffer + header_size, used);
+        remaining -= used;
+    }
+    if (remaining != 0) {
+        throw std::runtime_error(file_.path() + ": chain size mismatch");
+    }
+}
+
+uint32_t PageFile::write(
+    const char* data,
+    uint64_t size,
+    const Chain* old,
+    uint64_t unchanged) {
+    Chain chain;
+    chain.size_ = size;
+    if (old != nullptr) {
+        const size_t kept = std::min<uint64_t>(
+            old->pages_.size(), unchanged / payload_size);
+        chain.pages_.assign(old->pages_.begin(), old->pages_.begin() + kept);
+        stats_.pages_kept_ += kept;
+    }
+    for (uint64_t offset = chain.pages_.size() * payload_size; offset < size;
+         offset += payload_size) {
+        const uint32_t page = allocate();
+        write_page(
+            page,
+            data_page,
+            data + offset,
+            std::min<uint64_t>(payload_size, size - offset),
+            no_page);
+        chain.pages_.push_back(page);
+        ++stats_.pages_written_;
+    }
+    next_chains_.push_back(std::move(chain));
+    return static_cast<uint32_t>(next_chains_.size() - 1);
+}
+
+CheckpointStats PageFile::checkpoint(uint64_t lsn, std::string catalog) {
+    try {
+        std::string meta;
+        store_u32(meta, static_cast<uint32_t>(next_chains_.size()));
+        for (const Chain& chain : next_chains_) {
+            store_u64(meta, chain.size_);
+            store_u32(meta, static_cast<uint32_t>(chain.pages_.size()));
+            for (const uint32_t page : chain.pages_) {
+                store_u32(meta, page);
+            }
+        }
+        store_string(meta, catalog);
+
+        std::vector<uint32_t> meta_pages(pages_for(meta.size()));
+        for (uint32_t& page : meta_pages) {
+            page = allocate();
+        }
+        for (size_t i = 0; i < meta_pages.size(); ++i) {
+            const size_t offset = i * payload_size;
+            write_page(
+                meta_pages[i],
+                meta_page,
+                meta.data() + offset,
+                std::min(payload_size, meta.size() - offset),
+                i + 1 < meta_pages.size() ? meta_pages[i + 1] : no_page);
+        }
+        stats_.pages_written_ += meta_pages.size();
+        flush_pages();
+        file_.sync();
+
+        Root root;
+        root.sequence_ = root_.sequence_ + 1;
+        root.lsn_ = lsn;
+        root.meta_page_ = meta_pages.front();
+        root.page_count_ = next_page_count_;
+        write_root(root);
+        file_.sync();
+
+        root_ = root;
+        lsn_ = lsn;
+        catalog_ = std::move(catalog);
+        chains_ = std::move(next_chains_);
+        used_.assign(root.page_count_, false);
+        for (const Chain& chain : chains_) {
+            for (const uint32_t page : chain.pages_) {
+                used_[page] = true;
+            }
+        }
+        for (const uint32_t page : meta_pages) {
+            used_[page] = true;
+        }
+    } catch (...) {
+        reset_next();
+        throw;
+    }
+    const CheckpointStats stats = stats_;
+    reset_next();
+    return stats;
+}
+
+uint32_t PageFile::allocate() {
+    while ((next_free_ < used_.size()) && used_[next_free_]) {
+        ++next_free_;
+    }
+    const uint32_t page = next_free_++;
+    next_page_count_ = std::max(next_page_count_, next_free_);
+    return page;
+}
+
+void PageFile::write_page(
+    uint32_t page,
+    uint32_t kind,
+    const char* payload,
+    size_t size,
+    uint32_t next) {
+    const size_t pending_pages = pending_.size() / page_size;
+    if ((pending_pages > 0) &&
+        ((page != pending_first_ + pending_pages) ||
+         (pending_pages == max_pending_pages))) {
+        flush_pages();
+    }
+    if (pending_.empty()) {
+        pending_first_ = page;
+    }
+
+    const size_t begin = pending_.size();
+    store_u32(pending_, 0);
+    store_u32(pending_, kind);
+    store_u32(pending_, static_cast<uint32_t>(size));
+    store_u32(pending_, next);
+    pending_.append(payload, size);
+    pending_.resize(begin + page_size, '\0');
+    const char* written = pending_.data() + begin;
+    const uint32_t crc = crc32c(
+        written + sizeof(uint32_t), page_size - sizeof(uint32_t));
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        pending_[begin + i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+    }
+}
+
+bool PageFile::read_page(
+    uint32_t page,
+    uint32_t kind,
+    std::string& payload,
+    uint32_t& next) const {
+    char buffer[page_size];
+    if (!file_.read_at(uint64_t(page) * page_size, buffer, page_size) ||
+        !is_intact(buffer, kind)) {
+        return false;
+    }
+    payload.assign(buffer + header_size, used_bytes(buffer));
+    next = load_u32(buffer + 12);
+    return true;
+}
+
+void PageFile::flush_pages() {
+    if (pending_.empty()) {
+        return;
+    }
+    file_.write_at(
+        uint64_t(pending_first_) * page_size, pending_.data(), pending_.size());
+    pending_.clear();
+}
+
+void PageFile::prefetch(const Chain& chain, size_t first) const {
+    const size_t end = std::min(
+        chain.pages_.size(),
+        first + (first == 0 ? 2 : 1) * prefetch_pages);
+    // Runs of consecutive pages go out as one request.
+    size_t begin = first;
+    for (size_t i = first + 1; i <= end; ++i) {
+        if ((i < end) && (chain.pages_[i] == chain.pages_[i - 1] + 1)) {
+            continue;
+        }
+        if (begin < end) {
+            file_.prefetch(
+                uint64_t(chain.pages_[begin]) * page_size,
+                uint64_t(i - begin) * page_size);
+        }
+        begin = i;
+    }
+}
+
+std::runtime_error PageFile::corrupt_page(uint32_t page) const {
+    return std::runtime_error(
+        file_.path() + ": corrupt page " + std::to_string(page));
+}
+
+void PageFile::reset_next() {
+    next_chains_.clear();
+    next_free_ = 2;
+    next_page_count_ = std::max<uint32_t>(2, root_.page_count_);
+    stats_ = {};
+    pending_.clear();
+}
+
+bool PageFile::read_root(uint32_t slot, Root& root) const {
+    std::string payload;
+    uint32_t next = 0;
+    if (!read_page(slot, root_page, payload, next) ||
+        (payload.size() != 36) || (payload.compare(0, 4, magic) != 0)) {
+        return false;
+    }
+    const char* data = payload.data();
+    if ((load_u32(data + 4) != version) ||
+        (load_u32(data + 8) != page_size)) {
+        return false;
+    }
+    root.sequence_ = load_u64(data + 12);
+    root.lsn_ = load_u64(data + 20);
+    root.meta_page_ = load_u32(data + 28);
+    root.page_count_ = load_u32(data + 32);
+    return (root.meta_page_ >= 2) && (root.meta_page_ < root.page_count_);
+}
+
+void PageFile::write_root(const Root& root) {
+    std::string payload(magic);
+    store_u32(payload, version);
+    store_u32(payload, page_size);
+    store_u64(payload, root.sequence_);
+    store_u64(payload, root.lsn_);
+    store_u32(payload, root.meta_page_);
+    store_u32(payload, root.page_count_);
+    write_page(
+        static_cast<uint32_t>(root.sequence_ % 2),
+        root_page,
+        payload.data(),
+        payload.size(),
+        no_page);
+    flush_pages();
+}
+
+void PageFile::load(const Root& root) {
+    std::vector<bool> used(root.page_count_, false);
+    std::string meta;
+    std::string payload;
+    for (uint32_t page = root.meta_page_; page != no_page;) {
+        if ((page < 2) || (page >= used.size()) || used[page]) {
+            throw corrupt_page(page);
+        }
+        used[page] = true;
+        uint32_t next = no_page;
+        if (!read_page(page, meta_page, payload, next)) {
+            throw corrupt_page(page);
+        }
+        meta += payload;
+        page = next;
+    }
+
+    Decoder decoder(meta.data(), meta.size());
+    std::vector<Chain> chains(decoder.u32());
+    for (Chain& chain : chains) {
+        chain.size_ = decoder.u64();
+        chain.pages_.resize(decoder.u32());
+        if (chain.pages_.size() != pages_for(chain.size_)) {
+            throw std::runtime_error(file_.path() + ": corrupt chain");
+        }
+        for (uint32_t& page : chain.pages_) {
+            page = decoder.u32();
+            if ((page < 2) || (page >= used.size()) || used[page]) {
+                throw corrupt_page(page);
+            }
+            used[page] = true;
+        }
+    }
+    std::string catalog = decoder.string();
+
+    root_ = root;
+    lsn_ = root.lsn_;
+    catalog_ = std::move(catalog);
+    chains_ = std::move(chains);
+    used_ = std::move(used);
+    reset_next();
+}
+
+}  // namespace rdb::storage
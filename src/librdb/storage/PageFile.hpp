@@ -0,0 +1,129 @@
+#pragma once
+
+#include <librdb/storage/File.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rdb::storage {
+
+inline constexpr size_t page_size = 4096;
+
+// The pages holding one byte stream, e.g. the values of a column, in order.
+struct Chain {
+    std::vector<uint32_t> pages_;
+    uint64_t size_ = 0;
+};
+
+struct CheckpointStats {
+    size_t pages_written_ = 0;
+    // Pages of the previous checkpoint taken over unchanged.
+    size_t pages_kept_ = 0;
+};
+
+// A file of fixed-size pages holding one checkpoint: chains of data pages
+// plus a catalog that refers to them by index. Every page starts with a
+// header (CRC-32C of the rest of the page, kind, bytes used, next page).
+// Pages 0 and 1 are alternate roots; the valid one with the higher sequence
+// number is current and points to a chain of meta pages holding the chain
+// list and the catalog.
+//
+// A checkpoint never overwrites a page the current one uses: changed
+// pages go to free pages, the data is synced, and only then is the other
+// root slot written and synced. A crash at any point leaves either the old
+// or the new checkpoint intact.
+//
+// Corrupt pages throw std::runtime_error, I/O errors std::system_error.
+class PageFile {
+   public:
+    // Bytes of a page after its header.
+    static constexpr size_t payload_size = page_size - 4 * sizeof(uint32_t);
+
+    // Creates an empty checkpoint if `path` does not exist or is empty.
+    explicit PageFile(std::string path);
+
+    // The WAL position the current checkpoint includes.
+    uint64_t lsn() const { return lsn_; }
+    const std::string& catalog() const { return catalog_; }
+    const std::vector<Chain>& chains() const { return chains_; }
+
+    using Consume = std::function<void(const char* data, size_t size)>;
+
+    // The bytes of `chain`, checking every page.
+    std::string read(const Chain& chain) const;
+    // Passes the bytes of `chain` to `consume` a page at a time, asking
+    // for the pages after it to be read ahead, so that a long chain does
+    // not need its size in memory.
+    void scan(const Chain& chain, const Consume& consume) const;
+
+    // Adds a chain holding `size` bytes at `data` to the next checkpoint
+    // and returns its index there. `old`, a chain of the current
+    // checkpoint, must hold the same first `unchanged` bytes: its pages
+    // holding only those are reused rather than written again.
+    uint32_t write(
+        const char* data,
+        uint64_t size,
+        const Chain* old = nullptr,
+        uint64_t unchanged = 0);
+    // Makes the chains written since the last checkpoint and `catalog` the
+    // current checkpoint.
+    CheckpointStats checkpoint(uint64_t lsn, std::string catalog);
+
+   private:
+    struct Root {
+        uint64_t sequence_ = 0;
+        uint64_t lsn_ = 0;
+        uint32_t meta_page_ = 0;
+        uint32_t page_count_ = 0;
+    };
+
+    // A page not used by the current checkpoint.
+    uint32_t allocate();
+    // Writes `payload` to `page` as a page of kind `kind`.
+    void write_page(
+        uint32_t page,
+        uint32_t kind,
+        const char* payload,
+        size_t size,
+        uint32_t next);
+    // The payload and next page of `page`, or false if it is not an
+    // intact page of kind `kind`.
+    bool read_page(
+        uint32_t page,
+        uint32_t kind,
+        std::string& payload,
+        uint32_t& next) const;
+    void flush_pages();
+    void reset_next();
+    // Asks for the pages of `chain` from index `first` on to be read
+    // ahead.
+    void prefetch(const Chain& chain, size_t first) const;
+    std::runtime_error corrupt_page(uint32_t page) const;
+
+    bool read_root(uint32_t slot, Root& root) const;
+    void write_root(const Root& root);
+    void load(const Root& root);
+
+    File file_;
+    Root root_;
+    uint64_t lsn_ = 0;
+    std::string catalog_;
+    std::vector<Chain> chains_;
+    // By page: whether the current checkpoint uses it.
+    std::vector<bool> used_;
+
+    // The next checkpoint.
+    std::vector<Chain> next_chains_;
+    uint32_t next_free_ = 2;
+    uint32_t next_page_count_ = 2;
+    CheckpointStats stats_;
+    // Consecutive pages waiting to be written at once.
+    uint32_t pending_first_ = 0;
+    std::string pending_;
+};
+
+}  // namespace rdb::storage
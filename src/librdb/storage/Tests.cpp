@@ -0,0 +1,373 @@
+#include <librdb/engine/Column.hpp>
+#include <librdb/engine/Engine.hpp>
+#include <librdb/engine/TestUtil.hpp>
+#include <librdb/storage/Checksum.hpp>
+#include <librdb/storage/Database.hpp>
+#include <librdb/storage/File.hpp>
+#include <librdb/storage/PageFile.hpp>
+#include <librdb/storage/Wal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using rdb::engine::test::execute;
+
+namespace {
+
+// An empty directory for one test.
+std::string make_directory(const char* name) {
+    const std::string path = testing::TempDir() + name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+std::vector<std::string> replay(rdb::storage::Wal& wal, uint64_t after = 0) {
+    std::vector<std::string> records;
+    wal.replay(after, [&](uint64_t /*lsn*/, std::string_view payload) {
+        records.emplace_back(payload);
+    });
+    return records;
+}
+
+}  // namespace
+
+TEST(StorageSuite, ChecksumTest) {
+    const std::string_view check = "123456789";
+    EXPECT_EQ(0xE3069283U, rdb::storage::crc32c(check.data(), check.size()));
+
+    const std::string text(1000, 'x');
+    const uint32_t whole = rdb::storage::crc32c(text.data(), text.size());
+    const uint32_t head = rdb::storage::crc32c(text.data(), 333);
+    const uint32_t tail =
+        rdb::storage::crc32c(text.data() + 333, text.size() - 333, head);
+    EXPECT_EQ(whole, tail);
+}
+
+TEST(StorageSuite, WalReplayTest) {
+    const std::string path = make_directory("librdb_wal") + "/wal.log";
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_TRUE(replay(wal).empty());
+        EXPECT_EQ(1U, wal.append("first"));
+        EXPECT_EQ(2U, wal.append(""));
+        wal.commit(2);
+        EXPECT_EQ(3U, wal.append("third"));
+        wal.commit(3);
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_EQ(
+            (std::vector<std::string>{"first", "", "third"}), replay(wal));
+        EXPECT_EQ(3U, wal.last_lsn());
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_EQ(std::vector<std::string>{"third"}, replay(wal, 2));
+    }
+
+    // A record cut short by a crash is dropped, and appends go after the
+    // last intact one.
+    {
+        rdb::storage::File file(path);
+        file.truncate(file.size() - 2);
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_EQ((std::vector<std::string>{"first", ""}), replay(wal));
+        EXPECT_EQ(3U, wal.append("again"));
+        wal.commit(3);
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_EQ(
+            (std::vector<std::string>{"first", "", "again"}), replay(wal));
+
+        // LSNs keep counting after a reset.
+        wal.reset();
+        EXPECT_EQ(4U, wal.append("fourth"));
+        wal.commit(4);
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_EQ(std::vector<std::string>{"fourth"}, replay(wal, 3));
+    }
+
+    // So does a corrupt one.
+    {
+        rdb::storage::File file(path);
+        const char byte = 'X';
+        file.write_at(file.size() - 1, &byte, 1);
+    }
+    {
+        rdb::storage::Wal wal(path);
+        EXPECT_TRUE(replay(wal, 3).empty());
+        EXPECT_EQ(4U, wal.append("fourth"));
+    }
+}
+
+TEST(StorageSuite, GroupCommitTest) {
+    const std::string path = make_directory("librdb_group_commit") + "/wal";
+    {
+        rdb::storage::Wal wal(path);
+        replay(wal);
+        wal.append("a");
+        wal.append("b");
+        const uint64_t lsn = wal.append("c");
+
+        // One sync covers every record appended before it.
+        wal.commit(lsn);
+        EXPECT_EQ(1U, wal.sync_count());
+        wal.commit(1);
+        EXPECT_EQ(1U, wal.sync_count());
+    }
+
+    const size_t thread_count = 8;
+    const size_t records_per_thread = 50;
+    size_t syncs = 0;
+    {
+        rdb::storage::Wal wal(path);
+        replay(wal);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&wal, i] {
+                for (size_t j = 0; j < records_per_thread; ++j) {
+                    wal.commit(wal.append(std::to_string(i)));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        syncs = wal.sync_count();
+        EXPECT_LE(syncs, thread_count * records_per_thread);
+    }
+
+    rdb::storage::Wal wal(path);
+    std::vector<size_t> counts(thread_count);
+    wal.replay(3, [&](uint64_t /*lsn*/, std::string_view payload) {
+        ++counts.at(std::stoul(std::string(payload)));
+    });
+    EXPECT_EQ(std::vector<size_t>(thread_count, records_per_thread), counts);
+}
+
+TEST(StorageSuite, PageFileTest) {
+    const std::string path = make_directory("librdb_page_file") + "/pages";
+    const std::string data(rdb::storage::PageFile::payload_size * 3 + 5, 'a');
+    {
+        rdb::storage::PageFile file(path);
+        EXPECT_EQ(0U, file.lsn());
+        EXPECT_TRUE(file.chains().empty());
+        EXPECT_EQ(0U, file.write(data.data(), data.size()));
+        EXPECT_EQ(1U, file.write(nullptr, 0));
+        const auto stats = file.checkpoint(7, "catalog");
+        // Four data pages and one meta page.
+        EXPECT_EQ(5U, stats.pages_written_);
+    }
+    {
+        rdb::storage::PageFile file(path);
+        EXPECT_EQ(7U, file.lsn());
+        EXPECT_EQ("catalog", file.catalog());
+        ASSERT_EQ(2U, file.chains().size());
+        EXPECT_TRUE(data == file.read(file.chains()[0]));
+        EXPECT_EQ("", file.read(file.chains()[1]));
+
+        // Only the pages past the unchanged bytes are written again, to
+        // pages the last checkpoint does not use.
+        std::string changed = data;
+        changed.back() = 'b';
+        changed += "cd";
+        const auto old = file.chains()[0];
+        file.write(changed.data(), changed.size(), &old, data.size() - 1);
+        const auto stats = file.checkpoint(8, "next");
+        EXPECT_EQ(2U, stats.pages_written_);
+        EXPECT_EQ(3U, stats.pages_kept_);
+        EXPECT_TRUE(changed == file.read(file.chains()[0]));
+        for (size_t page = 0; page < 3; ++page) {
+            EXPECT_EQ(old.pages_[page], file.chains()[0].pages_[page]);
+        }
+        EXPECT_NE(old.pages_[3], file.chains()[0].pages_[3]);
+    }
+
+    // A torn root leaves the checkpoint before it current.
+    {
+        rdb::storage::File file(path);
+        const char byte = 'X';
+        file.write_at(rdb::storage::page_size + 100, &byte, 1);
+    }
+    rdb::storage::PageFile file(path);
+    EXPECT_EQ(7U, file.lsn());
+    EXPECT_EQ("catalog", file.catalog());
+    EXPECT_TRUE(data == file.read(file.chains()[0]));
+}
+
+TEST(StorageSuite, PageFileScanTest) {
+    const std::string path = make_directory("librdb_page_scan") + "/pages";
+    std::string data;
+    for (size_t i = 0; i < 100 * rdb::storage::PageFile::payload_size; ++i) {
+        data.push_back(static_cast<char>(i % 251));
+    }
+    {
+        rdb::storage::PageFile file(path);
+        file.write(data.data(), data.size());
+        file.checkpoint(1, {});
+    }
+
+    rdb::storage::PageFile file(path);
+    std::string read;
+    file.scan(file.chains()[0], [&](const char* page, size_t size) {
+        EXPECT_EQ(rdb::storage::PageFile::payload_size, size);
+        read.append(page, size);
+    });
+    EXPECT_TRUE(data == read);
+}
+
+TEST(StorageSuite, DatabaseReplayTest) {
+    const std::string directory = make_directory("librdb_database_replay");
+    const std::string select =
+        "SELECT id score name FROM t WHERE id > 1;"
+        "SELECT name FROM t WHERE score = 3.5;";
+    std::string expected;
+    {
+        rdb::storage::Database database(directory);
+        EXPECT_EQ(
+            "0\n3\n1\n0\n",
+            execute(
+                database,
+                "CREATE TABLE t (id INT, score REAL, name TEXT);"
+                "INSERT INTO t (id, score, name) VALUES (1, 2.5, \"a\"), "
+                "(2, 3.5, \"bb\"), (3, 4.5, \"\");"
+                "DELETE FROM t WHERE id = 1;"
+                "CREATE INDEX byscore ON t (score) USING BTREE;"));
+        EXPECT_EQ(
+            "No table 'u'\n", execute(database, "DROP TABLE u;"));
+        expected = execute(database, select);
+        EXPECT_EQ("2 3.500000 bb;3 4.500000 ;\nbb;\n", expected);
+    }
+
+    rdb::storage::Database database(directory);
+    EXPECT_EQ(expected, execute(database, select));
+    const auto table = database.catalog().find_table("t");
+    ASSERT_NE(nullptr, table);
+    ASSERT_NE(nullptr, table->find_index("byscore"));
+}
+
+TEST(StorageSuite, DatabaseCheckpointTest) {
+    const std::string directory = make_directory("librdb_database_checkpoint");
+    const std::string select = "SELECT id name FROM t WHERE id >= 4998;";
+    {
+        rdb::storage::Database database(directory);
+        std::string insert = "INSERT INTO t (id, name) VALUES ";
+        for (int32_t id = 0; id < 5000; ++id) {
+            const std::string name(static_cast<size_t>(id % 7), 'x');
+            insert += (id == 0 ? "(" : ", (") + std::to_string(id) + ", \"" +
+                name + "\")";
+        }
+        execute(database, "CREATE TABLE t (id INT, name TEXT);" + insert + ";");
+        execute(database, "CREATE INDEX byid ON t (id) USING HASH;");
+        const auto stats = database.checkpoint();
+        EXPECT_EQ(0U, stats.pages_kept_);
+        EXPECT_EQ(0U, std::filesystem::file_size(directory + "/wal.log"));
+
+        // Only the last page of each chain and the meta page are written
+        // again.
+        execute(database, "INSERT INTO t (id, name) VALUES (5000, \"new\");");
+        const auto next = database.checkpoint();
+        EXPECT_EQ(11U, next.pages_kept_);
+        EXPECT_EQ(4U, next.pages_written_);
+        execute(database, "DELETE FROM t WHERE id = 4999;");
+    }
+
+    rdb::storage::Database database(directory);
+    EXPECT_EQ("4998 ;5000 new;\n", execute(database, select));
+    ASSERT_TRUE(database.catalog().has_index("byid"));
+    EXPECT_EQ("\n", execute(database, "SELECT id FROM t WHERE id = 4999;"));
+
+    // A dropped table does not come back after a checkpoint.
+    execute(database, "DROP TABLE t;");
+    database.checkpoint();
+    rdb::storage::Database reopened(directory);
+    EXPECT_EQ(0U, reopened.catalog().size());
+}
+
+TEST(StorageSuite, DatabaseVacuumTest) {
+    const std::string directory = make_directory("librdb_database_vacuum");
+    {
+        rdb::storage::Database database(directory);
+        execute(database, "CREATE TABLE t (id INT, name TEXT);");
+
+        // Readers run alongside the writer and see whole INSERTs and
+        // DELETEs of ten rows each.
+        std::atomic<bool> done = false;
+        std::thread reader([&] {
+            while (!done) {
+                const std::string rows =
+                    execute(database, "SELECT id FROM t WHERE id >= 0;");
+                EXPECT_EQ(
+                    0, std::count(rows.begin(), rows.end(), ';') % 10);
+            }
+        });
+        for (int32_t batch = 0; batch < 100; ++batch) {
+            std::string insert = "INSERT INTO t (id, name) VALUES ";
+            for (int32_t id = batch * 10; id < batch * 10 + 10; ++id) {
+                insert += (id % 10 == 0 ? "(" : ", (") + std::to_string(id) +
+                    ", \"n\")";
+            }
+            execute(database, insert + ";");
+            if (batch % 2 == 1) {
+                execute(
+                    database,
+                    "DELETE FROM t WHERE id < " +
+                        std::to_string(batch / 2 * 10) +
+                        ";");
+            }
+        }
+        done = true;
+        reader.join();
+
+        // Deleted rows are dropped in the background once they make up a
+        // large enough part of the table.
+        database.wait_for_collector();
+        auto table = database.catalog().find_table("t");
+        EXPECT_FALSE(table->dead_fraction_at_least(
+            rdb::storage::Database::vacuum_fraction));
+        EXPECT_EQ(510U, table->row_count() - table->dead_rows());
+
+        execute(database, "DELETE FROM t WHERE id >= 800;");
+        database.wait_for_collector();
+        table = database.catalog().find_table("t");
+        EXPECT_EQ(0U, table->dead_rows());
+        EXPECT_EQ(310U, table->row_count());
+
+        // A few are left for later.
+        execute(database, "DELETE FROM t WHERE id = 799;");
+        database.wait_for_collector();
+        EXPECT_EQ(1U, database.catalog().find_table("t")->dead_rows());
+
+        // A checkpoint drops them itself.
+        database.checkpoint();
+        table = database.catalog().find_table("t");
+        EXPECT_EQ(0U, table->dead_rows());
+        EXPECT_EQ(309U, table->row_count());
+    }
+
+    rdb::storage::Database database(directory);
+    EXPECT_EQ(309U, database.catalog().find_table("t")->row_count());
+    EXPECT_EQ(
+        "\n490;\n",
+        execute(
+            database,
+            "SELECT id FROM t WHERE id = 489;"
+            "SELECT id FROM t WHERE id = 490;"));
+}
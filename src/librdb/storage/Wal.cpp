@@ -0,0 +1,151 @@
+#include <librdb/storage/Wal.hpp>
+
+#include <librdb/storage/Checksum.hpp>
+#include <librdb/storage/Encoding.hpp>
+#include <librdb/storage/File.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rdb::storage {
+
+namespace {
+
+// Payload size and checksum.
+constexpr size_t prefix_size = 2 * sizeof(uint32_t);
+constexpr size_t header_size = prefix_size + sizeof(uint64_t);
+
+}  // namespace
+
+Wal::Wal(std::string path) : file_(std::move(path)) {}
+
+void Wal::replay(uint64_t after, const Apply& apply) {
+    const uint64_t size = file_.size();
+    std::string log(size, '\0');
+    file_.read_at(0, log.data(), log.size());
+
+    // Start past `after` in case the log was reset after a checkpoint.
+    uint64_t last_lsn = after;
+    size_t offset = 0;
+    while (log.size() - offset >= header_size) {
+        const char* record = log.data() + offset;
+        const uint32_t payload_size = load_u32(record);
+        if (payload_size > log.size() - offset - header_size) {
+            break;
+        }
+        const size_t checked_size = header_size - prefix_size + payload_size;
+        if (load_u32(record + sizeof(uint32_t)) !=
+            crc32c(record + prefix_size, checked_size)) {
+            break;
+        }
+        const uint64_t lsn = load_u64(record + prefix_size);
+        if (lsn > after) {
+            apply(lsn, std::string_view(record + header_size, payload_size));
+        }
+        last_lsn = std::max(last_lsn, lsn);
+        offset += header_size + payload_size;
+    }
+
+    if (offset != log.size()) {
+        file_.truncate(offset);
+        file_.sync();
+    }
+    std::lock_guard lock(mutex_);
+    file_size_ = offset;
+    next_lsn_ = last_lsn + 1;
+    durable_lsn_ = last_lsn;
+}
+
+uint64_t Wal::append(std::string_view payload) {
+    std::string header;
+    std::lock_guard lock(mutex_);
+    const uint64_t lsn = next_lsn_++;
+    store_u64(header, lsn);
+    uint32_t crc = crc32c(header.data(), header.size());
+    crc = crc32c(payload.data(), payload.size(), crc);
+
+    store_u32(buffer_, static_cast<uint32_t>(payload.size()));
+    store_u32(buffer_, crc);
+    buffer_ += header;
+    buffer_ += payload;
+    return lsn;
+}
+
+void Wal::commit(uint64_t lsn) {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        throw_if_failed();
+        if (durable_lsn_ >= lsn) {
+            return;
+        }
+        if (!syncing_) {
+            break;
+        }
+        synced_.wait(lock);
+    }
+
+    syncing_ = true;
+    std::string batch = std::move(spare_);
+    batch.swap(buffer_);
+    const uint64_t batch_lsn = next_lsn_ - 1;
+    const uint64_t offset = file_size_;
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+        file_.write_at(offset, batch.data(), batch.size());
+        file_.sync();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+    syncing_ = false;
+    if (error) {
+        error_ = error;
+    } else {
+        file_size_ = offset + batch.size();
+        durable_lsn_ = batch_lsn;
+        ++sync_count_;
+    }
+    batch.clear();
+    spare_ = std::move(batch);
+    synced_.notify_all();
+    throw_if_failed();
+}
+
+void Wal::reset() {
+    std::unique_lock lock(mutex_);
+    synced_.wait(lock, [this] { return !syncing_; });
+    throw_if_failed();
+    file_.truncate(0);
+    file_.sync();
+    buffer_.clear();
+    file_size_ = 0;
+    durable_lsn_ = next_lsn_ - 1;
+    synced_.notify_all();
+}
+
+uint64_t Wal::last_lsn() const {
+    std::lock_guard lock(mutex_);
+    return next_lsn_ - 1;
+}
+
+size_t Wal::sync_count() const {
+    std::lock_guard lock(mutex_);
+    return sync_count_;
+}
+
+void Wal::throw_if_failed() const {
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+}  // namespace rdb::storage
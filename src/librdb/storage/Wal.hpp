@@ -0,0 +1,72 @@
+#pragma once
+
+#include <librdb/storage/File.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace rdb::storage {
+
+// Append-only write-ahead log. Each record is
+//
+//   u32 payload size, u32 CRC-32C of the rest, u64 LSN, payload
+//
+// LSNs increase by one per record, also across reset(). A record is
+// durable once a commit() of its LSN or a later one has returned.
+//
+// commit() is a group commit: the first caller becomes the leader and
+// writes and syncs everything appended so far, including records of other
+// threads, while those threads wait for it instead of syncing themselves.
+// Records appended during a sync go out together with the next one.
+class Wal {
+   public:
+    using Apply = std::function<void(uint64_t lsn, std::string_view payload)>;
+
+    explicit Wal(std::string path);
+
+    // Calls `apply` on every intact record after LSN `after`, in order. The
+    // log is cut at the first torn or corrupt record, which a crash during
+    // its write leaves behind. Called once, before anything is appended.
+    void replay(uint64_t after, const Apply& apply);
+
+    // Buffers a record and returns its LSN.
+    uint64_t append(std::string_view payload);
+    // Returns once the record `lsn` is durable. Throws std::system_error if
+    // the log could not be written; the log is unusable afterwards.
+    void commit(uint64_t lsn);
+
+    // Empties the log once everything in it is stored elsewhere. Waits for
+    // a commit in progress; records not committed yet count as durable.
+    void reset();
+
+    // The LSN of the last record appended.
+    uint64_t last_lsn() const;
+    // Syncs done by commit(), to observe batching.
+    size_t sync_count() const;
+
+   private:
+    void throw_if_failed() const;
+
+    File file_;
+    mutable std::mutex mutex_;
+    std::condition_variable synced_;
+    // Records appended but not written yet.
+    std::string buffer_;
+    // The previous batch, kept to reuse its memory.
+    std::string spare_;
+    uint64_t next_lsn_ = 1;
+    uint64_t durable_lsn_ = 0;
+    uint64_t file_size_ = 0;
+    // Whether a leader is writing outside the lock.
+    bool syncing_ = false;
+    std::exception_ptr error_;
+    size_t sync_count_ = 0;
+};
+
+}  // namespace rdb::storage